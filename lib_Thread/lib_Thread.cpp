@@ -2,15 +2,28 @@
 #include "../main/rossa/function/function.h"
 #include "../main/rossa/parser/parser.h"
 #include "../main/rossa/symbol/symbol.h"
+#include "../main/rossa/global/global.h"
+#include "../main/rossa/collector/collector.h"
 #include "../main/mediator/mediator.h"
 
 #include <thread>
 #include <memory>
+#include <deque>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include <optional>
+
+#define TIMER_TICK_MS 1
+#define TIMER_SLOTS 512
 
 namespace lib_thread
 {
-    inline void threadWrapper(const ptr_function_t &f)
+    // `scopes` keeps the lexical chain of `f` alive until the thread is done with it
+    inline void threadWrapper(const ptr_function_t &f, gc_heap_t *heap, const std::vector<object_t> &scopes)
     {
+        refcount_t::threaded = true;
+        collector_t::heap = heap;
         trace_t stack_trace;
         try
         {
@@ -21,12 +34,576 @@ namespace lib_thread
             parser_t::printError(e);
         }
     }
+
+    // Completion of one task; the task stores its own result in the Rossa Future, this only says when and whether it failed
+    struct future_t
+    {
+        std::mutex lock;
+        std::condition_variable cv;
+        bool done = false;
+        std::string error;
+        std::vector<std::function<void()>> continuations;
+
+        void complete(const std::string &error)
+        {
+            std::vector<std::function<void()>> then;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                done = true;
+                this->error = error;
+                then.swap(continuations);
+            }
+            cv.notify_all();
+            for (auto &f : then)
+                f();
+        }
+
+        // Runs `f` once this completes, immediately if it already has
+        void then(const std::function<void()> &f)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (!done)
+                {
+                    continuations.push_back(f);
+                    return;
+                }
+            }
+            f();
+        }
+
+        const bool isDone()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            return done;
+        }
+    };
+
+    struct task_t
+    {
+        ptr_function_t f;
+        std::shared_ptr<future_t> future;
+        std::vector<symbol_t> args;
+        // The block the task was submitted from may be left long before it runs, so it holds every scope `f` resolves names through
+        std::vector<object_t> scopes;
+        // The interpreter the task came from, whichever thread ends up running it
+        gc_heap_t *heap = collector_t::heap;
+
+        task_t() = default;
+
+        task_t(const ptr_function_t &f, const std::shared_ptr<future_t> &future, const std::vector<symbol_t> &args = {})
+            : f{f}, future{future}, args(args), scopes(f->getScopes())
+        {
+        }
+    };
+
+    // Completes once every part has, failing with the first error among them in order
+    inline const std::shared_ptr<future_t> whenAll(const std::vector<std::shared_ptr<future_t>> &futures)
+    {
+        auto all = std::make_shared<future_t>();
+        auto parts = std::make_shared<std::vector<std::shared_ptr<future_t>>>(futures);
+        auto remaining = std::make_shared<std::atomic<size_t>>(parts->size() + 1);
+        auto done = [all, remaining, parts]() {
+            if (--*remaining > 0)
+                return;
+            for (auto &f : *parts)
+            {
+                if (!f->error.empty())
+                    return all->complete(f->error);
+            }
+            all->complete("");
+        };
+        for (auto &f : *parts)
+            f->then(done);
+        done();
+        return all;
+    }
+
+    // A fixed set of workers, each owning a deque; a worker runs its newest task first and steals the oldest task of another worker when its own deque is empty
+    class pool_t
+    {
+    private:
+        struct queue_t
+        {
+            std::mutex lock;
+            std::deque<task_t> tasks;
+        };
+
+        std::vector<std::unique_ptr<queue_t>> queues;
+        std::vector<std::thread> workers;
+        std::mutex idleLock;
+        std::condition_variable idle;
+        std::atomic<size_t> pending{0};
+        std::atomic<size_t> next{0};
+        bool stopping = false;
+
+        static thread_local pool_t *current;
+        static thread_local size_t index;
+
+        const bool take(const size_t &i, task_t &task)
+        {
+            for (size_t k = 0; k < queues.size(); k++)
+            {
+                auto &q = *queues[(i + k) % queues.size()];
+                std::lock_guard<std::mutex> guard(q.lock);
+                if (q.tasks.empty())
+                    continue;
+                if (k == 0)
+                {
+                    task = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                }
+                else
+                {
+                    task = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                }
+                pending--;
+                return true;
+            }
+            return false;
+        }
+
+        static void run(const task_t &task)
+        {
+            collector_t::heap = task.heap;
+            trace_t stack_trace;
+            try
+            {
+                function_evaluate(task.f, task.args, NULL, stack_trace);
+                task.future->complete("");
+            }
+            catch (const rossa_error_t &e)
+            {
+                task.future->complete(e.what());
+            }
+            // Anything else escaping a task would end the worker thread and the process with it
+            catch (const std::exception &e)
+            {
+                task.future->complete(e.what());
+            }
+            catch (...)
+            {
+                task.future->complete("Unknown error in pool task");
+            }
+        }
+
+        void work(const size_t i)
+        {
+            refcount_t::threaded = true;
+            current = this;
+            index = i;
+            while (true)
+            {
+                task_t task;
+                if (take(i, task))
+                {
+                    run(task);
+                    continue;
+                }
+                std::unique_lock<std::mutex> guard(idleLock);
+                idle.wait(guard, [&]() { return stopping || pending > 0; });
+                if (stopping && pending == 0)
+                    return;
+            }
+        }
+
+    public:
+        pool_t(size_t size)
+        {
+            if (size == 0)
+                size = std::max<size_t>(1, std::thread::hardware_concurrency());
+            for (size_t i = 0; i < size; i++)
+                queues.push_back(std::make_unique<queue_t>());
+            for (size_t i = 0; i < size; i++)
+                workers.emplace_back(&pool_t::work, this, i);
+        }
+
+        ~pool_t()
+        {
+            shutdown();
+        }
+
+        const size_t size() const
+        {
+            return workers.size();
+        }
+
+        // Tasks submitted from one of this pool's workers stay on that worker's deque
+        void submit(const task_t &task)
+        {
+            // Idle workers run no Rossa code, so an unused pool (or an isolate that merely loads this library) keeps reference counts cheap
+            refcount_t::threaded = true;
+            const size_t i = current == this ? index : next++ % queues.size();
+            {
+                std::lock_guard<std::mutex> guard(queues[i]->lock);
+                queues[i]->tasks.push_back(task);
+            }
+            pending++;
+            {
+                std::lock_guard<std::mutex> guard(idleLock);
+            }
+            idle.notify_one();
+        }
+
+        // Finishes every queued task, then joins the workers
+        void shutdown()
+        {
+            {
+                std::lock_guard<std::mutex> guard(idleLock);
+                if (stopping)
+                    return;
+                stopping = true;
+            }
+            idle.notify_all();
+            for (auto &w : workers)
+            {
+                if (w.get_id() == std::this_thread::get_id())
+                    w.detach();
+                else if (w.joinable())
+                    w.join();
+            }
+        }
+
+        // A worker waiting on a future keeps running other tasks, so fan-out from inside a task cannot starve the pool
+        static void wait(const std::shared_ptr<future_t> &future)
+        {
+            while (current != NULL)
+            {
+                if (future->isDone())
+                    return;
+                task_t task;
+                if (current->take(index, task))
+                {
+                    run(task);
+                    continue;
+                }
+                std::unique_lock<std::mutex> guard(future->lock);
+                future->cv.wait_for(guard, std::chrono::milliseconds(1), [&]() { return future->done; });
+            }
+            std::unique_lock<std::mutex> guard(future->lock);
+            future->cv.wait(guard, [&]() { return future->done; });
+        }
+    };
+
+    thread_local pool_t *pool_t::current = NULL;
+    thread_local size_t pool_t::index = 0;
+
+    // Shared by `submit` and the timer; never destroyed, so workers still running at exit are not joined
+    inline const std::shared_ptr<pool_t> &defaultPool()
+    {
+        static auto *pool = new std::shared_ptr<pool_t>(std::make_shared<pool_t>(0));
+        return *pool;
+    }
+
+    // Hashed timing wheel on one thread; expired tasks are handed to the default pool, so the timer itself never runs Rossa code
+    class timer_t
+    {
+    private:
+        struct entry_t
+        {
+            size_t rounds;
+            task_t task;
+        };
+
+        std::mutex lock;
+        std::condition_variable wake;
+        std::vector<std::vector<entry_t>> slots;
+        size_t cursor = 0;
+        size_t count = 0;
+        std::chrono::steady_clock::time_point tick;
+
+        void run()
+        {
+            // Due tasks are copied out of their slots here, so this thread shares their values too
+            refcount_t::threaded = true;
+            std::unique_lock<std::mutex> guard(lock);
+            tick = std::chrono::steady_clock::now();
+            while (true)
+            {
+                if (count == 0)
+                {
+                    wake.wait(guard, [&]() { return count > 0; });
+                    tick = std::chrono::steady_clock::now();
+                }
+                tick += std::chrono::milliseconds(TIMER_TICK_MS);
+                wake.wait_until(guard, tick, []() { return false; });
+                cursor = (cursor + 1) % TIMER_SLOTS;
+
+                std::vector<task_t> due;
+                auto &slot = slots[cursor];
+                for (size_t i = 0; i < slot.size();)
+                {
+                    if (slot[i].rounds-- > 0)
+                    {
+                        i++;
+                        continue;
+                    }
+                    due.push_back(std::move(slot[i].task));
+                    slot[i] = std::move(slot.back());
+                    slot.pop_back();
+                }
+                count -= due.size();
+                guard.unlock();
+                for (auto &t : due)
+                    defaultPool()->submit(t);
+                guard.lock();
+            }
+        }
+
+    public:
+        timer_t()
+            : slots(TIMER_SLOTS)
+        {
+            std::thread(&timer_t::run, this).detach();
+        }
+
+        void schedule(const task_t &task, const size_t &ms)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                const size_t ticks = std::max<size_t>(1, ms / TIMER_TICK_MS);
+                slots[(cursor + ticks) % TIMER_SLOTS].push_back({(ticks - 1) / TIMER_SLOTS, task});
+                count++;
+            }
+            wake.notify_one();
+        }
+
+        static timer_t &get()
+        {
+            static auto *timer = new timer_t();
+            return *timer;
+        }
+    };
+
+    // Wakes threads blocked on a change; `notify` only touches the mutex when someone is actually asleep
+    class signal_t
+    {
+    private:
+        std::atomic<size_t> version{0};
+        std::atomic<size_t> sleepers{0};
+        std::mutex lock;
+        std::condition_variable cv;
+
+    public:
+        const size_t observe() const
+        {
+            return version.load();
+        }
+
+        void notify()
+        {
+            version++;
+            if (sleepers.load() == 0)
+                return;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+            }
+            cv.notify_all();
+        }
+
+        // Sleeps until anything changed since `seen`; false if the deadline passed first
+        const bool wait(const size_t &seen, const std::optional<std::chrono::steady_clock::time_point> &deadline)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            sleepers++;
+            bool changed = true;
+            if (deadline)
+                changed = cv.wait_until(guard, *deadline, [&]() { return version.load() != seen; });
+            else
+                cv.wait(guard, [&]() { return version.load() != seen; });
+            sleepers--;
+            return changed;
+        }
+    };
+
+    // Bounded multi-producer multi-consumer ring; each cell's sequence number says whether it is free for the producer or full for the consumer of the current lap, so neither side takes a lock unless it has to sleep
+    class channel_t
+    {
+    private:
+        struct cell_t
+        {
+            std::atomic<size_t> sequence;
+            std::optional<mediator_t> value;
+        };
+
+        const size_t capacity;
+        std::unique_ptr<cell_t[]> cells;
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+        std::atomic<bool> closed{false};
+        signal_t changed;
+
+    public:
+        // Woken whenever any channel receives a value, for `select`
+        static signal_t filled;
+
+        channel_t(const size_t &capacity)
+            : capacity{std::max<size_t>(2, capacity)}, cells{new cell_t[this->capacity]}
+        {
+            for (size_t i = 0; i < this->capacity; i++)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        const bool trySend(const mediator_t &value)
+        {
+            size_t pos = tail.load(std::memory_order_relaxed);
+            while (true)
+            {
+                auto &cell = cells[pos % capacity];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == pos)
+                {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        cell.value.emplace(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        changed.notify();
+                        filled.notify();
+                        return true;
+                    }
+                }
+                else if (sequence < pos)
+                    return false;
+                else
+                    pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        const bool tryRecv(std::optional<mediator_t> &value)
+        {
+            size_t pos = head.load(std::memory_order_relaxed);
+            while (true)
+            {
+                auto &cell = cells[pos % capacity];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                if (sequence == pos + 1)
+                {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        value.emplace(*cell.value);
+                        cell.value.reset();
+                        cell.sequence.store(pos + capacity, std::memory_order_release);
+                        changed.notify();
+                        return true;
+                    }
+                }
+                else if (sequence < pos + 1)
+                    return false;
+                else
+                    pos = head.load(std::memory_order_relaxed);
+            }
+        }
+
+        void send(const mediator_t &value)
+        {
+            while (true)
+            {
+                if (closed)
+                    throw library_error_t("Cannot send on a closed channel");
+                const size_t seen = changed.observe();
+                if (trySend(value))
+                    return;
+                changed.wait(seen, std::nullopt);
+            }
+        }
+
+        // Empty once the channel is closed and drained
+        void recv(std::optional<mediator_t> &value)
+        {
+            while (true)
+            {
+                const size_t seen = changed.observe();
+                if (tryRecv(value) || isDrained())
+                    return;
+                changed.wait(seen, std::nullopt);
+            }
+        }
+
+        void close()
+        {
+            closed = true;
+            changed.notify();
+            filled.notify();
+        }
+
+        const bool isClosed() const
+        {
+            return closed;
+        }
+
+        // Closed with nothing left to receive; a send that claimed its slot just before the close counts as something until it has written it
+        const bool isDrained() const
+        {
+            return closed && head.load() == tail.load();
+        }
+    };
+
+    signal_t channel_t::filled;
+
+    // An interpreter of its own on a thread of its own, with its own heap and module registry; it shares no Rossa values with any other interpreter and only talks to its creator through two channels
+    struct isolate_t
+    {
+        std::shared_ptr<channel_t> inbox;
+        std::shared_ptr<channel_t> outbox;
+        std::thread thread;
+        std::string error;
+
+        // Only the isolate's own thread can drop the last reference while its script runs, and it is already on its way out
+        ~isolate_t()
+        {
+            if (!thread.joinable())
+                return;
+            if (thread.get_id() == std::this_thread::get_id())
+                thread.detach();
+            else
+                thread.join();
+        }
+    };
+
+    thread_local std::shared_ptr<isolate_t> currentIsolate;
+
+    inline void runIsolate(const std::shared_ptr<isolate_t> isolate, const std::filesystem::path path, const std::vector<std::string> args)
+    {
+        currentIsolate = isolate;
+        auto *heap = new gc_heap_t();
+        collector_t::heap = heap;
+        {
+            parser_t parser(args);
+            std::string content = KEYWORD_LOAD " \"standard\";\n";
+            try
+            {
+                dir::readFile(path, content);
+                auto entry = parser.compileCode(content, path);
+                parser.runCode(entry, false);
+            }
+            catch (const rossa_error_t &e)
+            {
+                isolate->error = e.what();
+            }
+            catch (const std::exception &e)
+            {
+                isolate->error = e.what();
+            }
+            catch (...)
+            {
+                isolate->error = "Unknown error in isolate";
+            }
+        }
+        collector_t::collect();
+        isolate->outbox->close();
+        // Scopes still alive here are held by something outside the isolate, such as a pool task, and keep their heap
+        if (heap->tracked == 0)
+            delete heap;
+        currentIsolate = nullptr;
+    }
 };
 
 ROSSA_EXT_SIG(_thread_init, args)
 {
+    refcount_t::threaded = true;
     auto f = COERCE_POINTER(args[0], function_t);
-    auto t = std::make_shared<std::thread>(lib_thread::threadWrapper, f);
+    auto t = std::make_shared<std::thread>(lib_thread::threadWrapper, f, collector_t::heap, f->getScopes());
     return MAKE_POINTER(t);
 }
 
@@ -50,9 +627,235 @@ ROSSA_EXT_SIG(_thread_detach, args)
     return mediator_t();
 }
 
-EXPORT_FUNCTIONS(lib_thread)
+ROSSA_EXT_SIG(_pool_init, args)
 {
+    auto pool = std::make_shared<lib_thread::pool_t>(COERCE_NUMBER(args[0]).getLong());
+    return MAKE_POINTER(pool);
+}
+
+ROSSA_EXT_SIG(_pool_default, args)
+{
+    return MAKE_POINTER(lib_thread::defaultPool());
+}
+
+ROSSA_EXT_SIG(_pool_size, args)
+{
+    auto pool = COERCE_POINTER(args[0], lib_thread::pool_t);
+    return MAKE_NUMBER(number_t::Long(pool->size()));
+}
+
+ROSSA_EXT_SIG(_pool_submit, args)
+{
+    auto pool = COERCE_POINTER(args[0], lib_thread::pool_t);
+    auto f = COERCE_POINTER(args[1], function_t);
+    auto future = COERCE_POINTER(args[2], lib_thread::future_t);
+
+    pool->submit({f, future});
+    return mediator_t();
+}
+
+// Runs `body(k)` for every chunk index k on the pool and returns once all of them have, rethrowing the first error
+ROSSA_EXT_SIG(_pool_parallel, args)
+{
+    auto pool = COERCE_POINTER(args[0], lib_thread::pool_t);
+    const size_t count = COERCE_NUMBER(args[1]).getLong();
+    auto body = COERCE_POINTER(args[2], function_t);
+
+    std::vector<std::shared_ptr<lib_thread::future_t>> chunks;
+    for (size_t k = 0; k < count; k++)
+    {
+        chunks.push_back(std::make_shared<lib_thread::future_t>());
+        pool->submit({body, chunks.back(), {symbol_t::Number(number_t::Long(k))}});
+    }
+    auto all = lib_thread::whenAll(chunks);
+    lib_thread::pool_t::wait(all);
+    if (!all->error.empty())
+        throw library_error_t(all->error);
+    return mediator_t();
+}
+
+ROSSA_EXT_SIG(_pool_shutdown, args)
+{
+    auto pool = COERCE_POINTER(args[0], lib_thread::pool_t);
+    pool->shutdown();
+    return mediator_t();
+}
+
+ROSSA_EXT_SIG(_future_init, args)
+{
+    auto future = std::make_shared<lib_thread::future_t>();
+    return MAKE_POINTER(future);
+}
+
+ROSSA_EXT_SIG(_future_all, args)
+{
+    std::vector<std::shared_ptr<lib_thread::future_t>> parts;
+    for (auto &p : COERCE_ARRAY(args[0]))
+        parts.push_back(COERCE_POINTER(p, lib_thread::future_t));
+    return MAKE_POINTER(lib_thread::whenAll(parts));
+}
+
+ROSSA_EXT_SIG(_future_wait, args)
+{
+    auto future = COERCE_POINTER(args[0], lib_thread::future_t);
+
+    lib_thread::pool_t::wait(future);
+    if (!future->error.empty())
+        throw library_error_t(future->error);
+    return mediator_t();
+}
+
+ROSSA_EXT_SIG(_future_ready, args)
+{
+    auto future = COERCE_POINTER(args[0], lib_thread::future_t);
+    return MAKE_BOOLEAN(future->isDone());
+}
+
+ROSSA_EXT_SIG(_timer_schedule, args)
+{
+    refcount_t::threaded = true;
+    auto f = COERCE_POINTER(args[0], function_t);
+    auto future = COERCE_POINTER(args[2], lib_thread::future_t);
+
+    lib_thread::timer_t::get().schedule({f, future}, COERCE_NUMBER(args[1]).getLong());
+    return mediator_t();
+}
+
+ROSSA_EXT_SIG(_channel_init, args)
+{
+    auto channel = std::make_shared<lib_thread::channel_t>(COERCE_NUMBER(args[0]).getLong());
+    return MAKE_POINTER(channel);
+}
+
+ROSSA_EXT_SIG(_channel_send, args)
+{
+    auto channel = COERCE_POINTER(args[0], lib_thread::channel_t);
+    channel->send(args[1]);
+    return mediator_t();
+}
+
+ROSSA_EXT_SIG(_channel_trySend, args)
+{
+    auto channel = COERCE_POINTER(args[0], lib_thread::channel_t);
+    if (channel->isClosed())
+        throw library_error_t("Cannot send on a closed channel");
+    return MAKE_BOOLEAN(channel->trySend(args[1]));
+}
+
+ROSSA_EXT_SIG(_channel_recv, args)
+{
+    auto channel = COERCE_POINTER(args[0], lib_thread::channel_t);
+    std::optional<mediator_t> value;
+    channel->recv(value);
+    return value ? *value : mediator_t();
+}
+
+ROSSA_EXT_SIG(_channel_tryRecv, args)
+{
+    auto channel = COERCE_POINTER(args[0], lib_thread::channel_t);
+    std::optional<mediator_t> value;
+    channel->tryRecv(value);
+    return value ? *value : mediator_t();
+}
+
+ROSSA_EXT_SIG(_channel_close, args)
+{
+    auto channel = COERCE_POINTER(args[0], lib_thread::channel_t);
+    channel->close();
+    return mediator_t();
+}
+
+// [index, value] from the first of the channels holding a value, or nil once they are all closed and drained or `ms` (unless negative) has passed
+ROSSA_EXT_SIG(_channel_select, args)
+{
+    std::vector<std::shared_ptr<lib_thread::channel_t>> channels;
+    for (auto &c : COERCE_ARRAY(args[0]))
+        channels.push_back(COERCE_POINTER(c, lib_thread::channel_t));
+    const long long ms = COERCE_NUMBER(args[1]).getLong();
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (ms >= 0)
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+
+    while (true)
+    {
+        const size_t seen = lib_thread::channel_t::filled.observe();
+        bool open = false;
+        for (size_t i = 0; i < channels.size(); i++)
+        {
+            // Checked first, so a value sent just before closing is still picked up below
+            open = open || !channels[i]->isDrained();
+            std::optional<mediator_t> value;
+            if (channels[i]->tryRecv(value))
+                return mediator_t(
+                    MEDIATOR_ARRAY,
+                    std::make_shared<std::vector<mediator_t>>(std::vector<mediator_t>({MAKE_NUMBER(number_t::Long(i)), *value})));
+        }
+        if (!open || !lib_thread::channel_t::filled.wait(seen, deadline))
+            return mediator_t();
+    }
+}
+
+ROSSA_EXT_SIG(_isolate_init, args)
+{
+    const std::filesystem::path path = COERCE_STRING(args[0]);
+    if (!std::filesystem::exists(path))
+        throw library_error_t("Isolate script does not exist: " + path.string());
+    std::vector<std::string> argv;
+    for (auto &a : COERCE_ARRAY(args[1]))
+        argv.push_back(COERCE_STRING(a));
+
+    auto isolate = std::make_shared<lib_thread::isolate_t>();
+    isolate->inbox = COERCE_POINTER(args[2], lib_thread::channel_t);
+    isolate->outbox = COERCE_POINTER(args[3], lib_thread::channel_t);
+    isolate->thread = std::thread(lib_thread::runIsolate, isolate, path, argv);
+    return MAKE_POINTER(isolate);
+}
+
+// Rethrows whatever ended the isolate's script
+ROSSA_EXT_SIG(_isolate_join, args)
+{
+    auto isolate = COERCE_POINTER(args[0], lib_thread::isolate_t);
+    if (isolate->thread.joinable())
+        isolate->thread.join();
+    if (!isolate->error.empty())
+        throw library_error_t(isolate->error);
+    return mediator_t();
+}
+
+// [inbox, outbox] of the isolate running on this thread, nil outside of one
+ROSSA_EXT_SIG(_isolate_parent, args)
+{
+    if (lib_thread::currentIsolate == nullptr)
+        return mediator_t();
+    return mediator_t(
+        MEDIATOR_ARRAY,
+        std::make_shared<std::vector<mediator_t>>(std::vector<mediator_t>({MAKE_POINTER(lib_thread::currentIsolate->inbox), MAKE_POINTER(lib_thread::currentIsolate->outbox)})));
+}
+
+EXPORT_FUNCTIONS(lib_Thread)
+{
+    ADD_EXT(_channel_close);
+    ADD_EXT(_channel_init);
+    ADD_EXT(_channel_recv);
+    ADD_EXT(_channel_select);
+    ADD_EXT(_channel_send);
+    ADD_EXT(_channel_trySend);
+    ADD_EXT(_channel_tryRecv);
+    ADD_EXT(_future_all);
+    ADD_EXT(_future_init);
+    ADD_EXT(_future_ready);
+    ADD_EXT(_future_wait);
+    ADD_EXT(_isolate_init);
+    ADD_EXT(_isolate_join);
+    ADD_EXT(_isolate_parent);
+    ADD_EXT(_pool_default);
+    ADD_EXT(_pool_init);
+    ADD_EXT(_pool_parallel);
+    ADD_EXT(_pool_shutdown);
+    ADD_EXT(_pool_size);
+    ADD_EXT(_pool_submit);
     ADD_EXT(_thread_detach);
     ADD_EXT(_thread_init);
     ADD_EXT(_thread_join);
-}
\ No newline at end of file
+    ADD_EXT(_timer_schedule);
+}
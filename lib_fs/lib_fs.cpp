@@ -1,17 +1,137 @@
 #include "../main/mediator/mediator.h"
+#include "../main/mediator/bytes.h"
 
 #include <zip.h>
 
 #include <cstring>
 #include <fstream>
 #include <filesystem>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
+#define FS_BUFFER_SIZE (1 << 20)
 
 namespace lib_fs
 {
-	inline void unzip(const std::filesystem::path &zipdir, const std::filesystem::path &unzipdir)
+	// Streams get a large buffer of their own so per-call overhead is not paid per byte; the buffer is declared first so it outlives the stream
+	struct reader_t
+	{
+		std::vector<char> buffer;
+		std::ifstream stream;
+
+		reader_t(const std::string &filename)
+			: buffer(FS_BUFFER_SIZE)
+		{
+			stream.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+			stream.open(filename, std::ios::binary);
+		}
+	};
+
+	struct writer_t
+	{
+		std::vector<char> buffer;
+		std::ofstream stream;
+
+		writer_t(const std::string &filename)
+			: buffer(FS_BUFFER_SIZE)
+		{
+			stream.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+			stream.open(filename, std::ios::binary);
+		}
+	};
+
+	// Read-only view of a whole file, mapped where the platform allows it
+	struct mapped_t
+	{
+		const char *data = NULL;
+		size_t size = 0;
+#ifdef _WIN32
+		std::string content;
+#endif
+
+		mapped_t(const std::string &filename)
+		{
+#ifndef _WIN32
+			int fd = open(filename.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw library_error_t("Failure to map filepath <" + filename + ">");
+			struct stat st;
+			if (fstat(fd, &st) != 0)
+			{
+				close(fd);
+				throw library_error_t("Failure to map filepath <" + filename + ">");
+			}
+			size = st.st_size;
+			if (size > 0)
+			{
+				void *p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p == MAP_FAILED)
+				{
+					close(fd);
+					throw library_error_t("Failure to map filepath <" + filename + ">");
+				}
+				madvise(p, size, MADV_SEQUENTIAL);
+				data = static_cast<const char *>(p);
+			}
+			close(fd);
+#else
+			std::ifstream file(filename, std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+				throw library_error_t("Failure to map filepath <" + filename + ">");
+			content.resize(file.tellg());
+			file.seekg(0, std::ios::beg);
+			file.read(&content[0], content.size());
+			data = content.data();
+			size = content.size();
+#endif
+		}
+
+		~mapped_t()
+		{
+#ifndef _WIN32
+			if (data != NULL)
+				munmap(const_cast<char *>(data), size);
+#endif
+		}
+	};
+
+	inline size_t readSize(const long_int_t &size)
+	{
+		if (size < 0)
+			throw library_error_t("Read size cannot be negative");
+		return static_cast<size_t>(size);
+	}
+
+	// Reads up to `max` bytes onto the end of `out` one buffer at a time, so a large request only allocates what the stream holds
+	template <typename T>
+	inline void readChunked(std::istream &stream, T &out, const size_t &max)
+	{
+		const size_t start = out.size();
+		while (out.size() - start < max)
+		{
+			const size_t at = out.size();
+			const size_t n = std::min<size_t>(max - (at - start), FS_BUFFER_SIZE);
+			out.resize(at + n);
+			stream.read(reinterpret_cast<char *>(&out[at]), n);
+			out.resize(at + stream.gcount());
+			if (static_cast<size_t>(stream.gcount()) < n)
+				break;
+		}
+	}
+
+	typedef std::unique_ptr<zip_t, decltype(&zip_discard)> archive_t;
+
+	inline archive_t openArchive(const std::filesystem::path &zipdir, const int &flags)
 	{
 		int error;
-		zip_t *z = zip_open(zipdir.string().c_str(), ZIP_RDONLY, &error);
+		zip_t *z = zip_open(zipdir.string().c_str(), flags, &error);
 		if (z == NULL)
 		{
 			switch (error)
@@ -31,58 +151,167 @@ namespace lib_fs
 				throw library_error_t("An error occured while attempting to open archive");
 			}
 		}
+		return archive_t(z, &zip_discard);
+	}
+
+	// Reads exactly `size` bytes of entry `index` into `out`
+	inline void readEntry(zip_t *z, const zip_uint64_t &index, char *out, const zip_uint64_t &size)
+	{
+		zip_file_t *f = zip_fopen_index(z, index, 0);
+		if (f == NULL)
+			throw library_error_t("Error reading file within archive (possibly corrupt)");
+		zip_uint64_t totalRead = 0;
+		while (totalRead != size)
+		{
+			zip_int64_t nlen = zip_fread(f, out + totalRead, size - totalRead);
+			if (nlen <= 0)
+			{
+				zip_fclose(f);
+				throw library_error_t("Error reading file within archive (possibly corrupt)");
+			}
+			totalRead += nlen;
+		}
+		zip_fclose(f);
+	}
 
+	inline void extractEntry(zip_t *z, const zip_uint64_t &index, const std::filesystem::path &unzipdir, std::vector<char> &buffer)
+	{
 		struct zip_stat statBuffer;
-		zip_file_t *f;
-		zip_uint64_t totalRead;
-		char binBuffer[100];
-		for (int i = 0; i < zip_get_num_entries(z, 0); i++)
+		if (zip_stat_index(z, index, 0, &statBuffer) != 0)
+			throw library_error_t("Error reading file within archive (possibly corrupt)");
+
+		zip_file_t *f = zip_fopen_index(z, index, 0);
+		if (f == NULL)
+			throw library_error_t("Error reading file within archive (possibly corrupt)");
+		std::ofstream file(unzipdir / statBuffer.name, std::ios_base::binary);
+		zip_uint64_t totalRead = 0;
+		while (totalRead != statBuffer.size)
 		{
-			if (zip_stat_index(z, i, 0, &statBuffer) == 0)
+			zip_int64_t nlen = zip_fread(f, buffer.data(), buffer.size());
+			if (nlen <= 0)
 			{
+				zip_fclose(f);
+				throw library_error_t("Error reading file within archive (possibly corrupt)");
+			}
+			file.write(buffer.data(), nlen);
+			totalRead += nlen;
+		}
+		zip_fclose(f);
+	}
+
+	inline void unzip(const std::filesystem::path &zipdir, const std::filesystem::path &unzipdir)
+	{
+		std::vector<zip_uint64_t> files;
+		{
+			archive_t z = openArchive(zipdir, ZIP_RDONLY);
+			struct zip_stat statBuffer;
+			zip_int64_t count = zip_get_num_entries(z.get(), 0);
+			// Directories are made up front so the workers below only ever write files
+			for (zip_int64_t i = 0; i < count; i++)
+			{
+				if (zip_stat_index(z.get(), i, 0, &statBuffer) != 0)
+					throw library_error_t("Error reading file within archive (possibly corrupt)");
 				if (statBuffer.name[strlen(statBuffer.name) - 1] == '/')
 				{
 					std::filesystem::create_directories(unzipdir / statBuffer.name);
 				}
 				else
 				{
-					f = zip_fopen_index(z, i, 0);
-					std::ofstream file(unzipdir / statBuffer.name, std::ios_base::binary);
-					totalRead = 0;
-					while (totalRead != statBuffer.size)
-					{
-						int nlen = zip_fread(f, binBuffer, 100);
-						if (nlen < 0)
-							throw library_error_t("Error reading file within archive (possibly corrupt)");
-						file.write(binBuffer, nlen);
-						totalRead += nlen;
-					}
-					file.close();
-					zip_fclose(f);
+					std::filesystem::create_directories((unzipdir / statBuffer.name).parent_path());
+					files.push_back(i);
 				}
 			}
-			else
+		}
+
+		// A zip_t cannot be shared between threads, so every worker opens the archive itself
+		std::atomic<size_t> next(0);
+		std::atomic<bool> failed(false);
+		std::exception_ptr failure;
+		std::mutex failureLock;
+		auto work = [&]() {
+			try
+			{
+				archive_t z = openArchive(zipdir, ZIP_RDONLY);
+				std::vector<char> buffer(FS_BUFFER_SIZE);
+				for (size_t k = next++; k < files.size() && !failed; k = next++)
+					extractEntry(z.get(), files[k], unzipdir, buffer);
+			}
+			catch (...)
 			{
-				throw library_error_t("Error reading file within archive (possibly corrupt)");
+				std::lock_guard<std::mutex> guard(failureLock);
+				if (!failed.exchange(true))
+					failure = std::current_exception();
 			}
-		}
+		};
+
+		size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), files.size());
+		std::vector<std::thread> threads;
+		for (size_t i = 1; i < workers; i++)
+			threads.emplace_back(work);
+		work();
+		for (auto &t : threads)
+			t.join();
+		if (failure)
+			std::rethrow_exception(failure);
+	}
 
-		if (zip_close(z) == -1)
+	inline void zip(const std::filesystem::path &sourcedir, const std::filesystem::path &zipdir)
+	{
+		archive_t z = openArchive(zipdir, ZIP_CREATE | ZIP_TRUNCATE);
+
+		auto add = [&](const std::filesystem::path &file, const std::string &name) {
+			zip_source_t *source = zip_source_file(z.get(), file.string().c_str(), 0, 0);
+			if (source == NULL || zip_file_add(z.get(), name.c_str(), source, ZIP_FL_OVERWRITE | ZIP_FL_ENC_UTF_8) < 0)
+			{
+				zip_source_free(source);
+				throw library_error_t("Failure to add <" + file.string() + "> to ZIP archive");
+			}
+		};
+
+		if (std::filesystem::is_directory(sourcedir))
 		{
-			throw library_error_t("Attempt to close ZIP archive failed");
+			for (auto &e : std::filesystem::recursive_directory_iterator(sourcedir))
+			{
+				const std::string name = std::filesystem::relative(e.path(), sourcedir).generic_string();
+				if (e.is_directory())
+				{
+					if (zip_dir_add(z.get(), name.c_str(), ZIP_FL_ENC_UTF_8) < 0)
+						throw library_error_t("Failure to add <" + e.path().string() + "> to ZIP archive");
+				}
+				else if (e.is_regular_file())
+				{
+					add(e.path(), name);
+				}
+			}
+		}
+		else
+		{
+			add(sourcedir, sourcedir.filename().generic_string());
 		}
+
+		if (zip_close(z.get()) == -1)
+			throw library_error_t("Attempt to close ZIP archive failed");
+		z.release();
+	}
+
+	inline const std::shared_ptr<bytes_t> readEntry(const std::filesystem::path &zipdir, const std::string &name)
+	{
+		archive_t z = openArchive(zipdir, ZIP_RDONLY);
+		struct zip_stat statBuffer;
+		if (zip_stat(z.get(), name.c_str(), 0, &statBuffer) != 0)
+			throw library_error_t("Entry <" + name + "> does not exist within archive");
+
+		auto b = std::make_shared<bytes_t>(statBuffer.size);
+		readEntry(z.get(), statBuffer.index, reinterpret_cast<char *>(b->begin()), statBuffer.size);
+		return b;
 	}
 }
 
 ROSSA_EXT_SIG(_writer_init, args)
 {
 	auto filename = COERCE_STRING(args[0]);
-	auto fstr = std::make_shared<std::ofstream>();
-	if (COERCE_BOOLEAN(args[1]))
-		fstr->open(filename, std::ios::binary);
-	else
-		fstr->open(filename, std::ios::binary);
-	if (!fstr->is_open())
+	auto fstr = std::make_shared<lib_fs::writer_t>(filename);
+	if (!fstr->stream.is_open())
 		throw library_error_t("Failure to initialize writer for filepath <" + filename + ">");
 
 	return MAKE_POINTER(fstr);
@@ -90,28 +319,24 @@ ROSSA_EXT_SIG(_writer_init, args)
 
 ROSSA_EXT_SIG(_writer_close, args)
 {
-	auto fstr = COERCE_POINTER(args[0], std::ofstream);
+	auto fstr = COERCE_POINTER(args[0], lib_fs::writer_t);
 
-	fstr->close();
+	fstr->stream.close();
 	return mediator_t();
 }
 
 ROSSA_EXT_SIG(_writer_isOpen, args)
 {
-	auto fstr = COERCE_POINTER(args[0], std::ofstream);
+	auto fstr = COERCE_POINTER(args[0], lib_fs::writer_t);
 
-	return MAKE_BOOLEAN(fstr->is_open());
+	return MAKE_BOOLEAN(fstr->stream.is_open());
 }
 
 ROSSA_EXT_SIG(_reader_init, args)
 {
 	auto filename = COERCE_STRING(args[0]);
-	auto fstr = std::make_shared<std::ifstream>();
-	if (COERCE_BOOLEAN(args[1]))
-		fstr->open(filename, std::ios::binary);
-	else
-		fstr->open(filename, std::ios::binary);
-	if (!fstr->is_open())
+	auto fstr = std::make_shared<lib_fs::reader_t>(filename);
+	if (!fstr->stream.is_open())
 		throw library_error_t("Failure to initialize reader for filepath <" + filename + ">");
 
 	return MAKE_POINTER(fstr);
@@ -119,65 +344,164 @@ ROSSA_EXT_SIG(_reader_init, args)
 
 ROSSA_EXT_SIG(_reader_close, args)
 {
-	auto fstr = COERCE_POINTER(args[0], std::ifstream);
+	auto fstr = COERCE_POINTER(args[0], lib_fs::reader_t);
 
-	fstr->close();
+	fstr->stream.close();
 	return mediator_t();
 }
 
 ROSSA_EXT_SIG(_reader_isOpen, args)
 {
-	auto fstr = COERCE_POINTER(args[0], std::ifstream);
+	auto fstr = COERCE_POINTER(args[0], lib_fs::reader_t);
 
-	return MAKE_BOOLEAN(fstr->is_open());
+	return MAKE_BOOLEAN(fstr->stream.is_open());
 }
 
 ROSSA_EXT_SIG(_reader_readLine, args)
 {
-	auto fstr = COERCE_POINTER(args[0], std::ifstream);
+	auto fstr = COERCE_POINTER(args[0], lib_fs::reader_t);
 
 	std::string line;
-	if (std::getline(*fstr, line))
-		return MAKE_STRING(line);
+	if (std::getline(fstr->stream, line))
+		return MAKE_STRING(std::move(line));
 	return mediator_t();
 }
 
+ROSSA_EXT_SIG(_reader_readLines, args)
+{
+	auto fstr = COERCE_POINTER(args[0], lib_fs::reader_t);
+
+	size_t max = lib_fs::readSize(COERCE_NUMBER(args[1]).getLong());
+
+	std::vector<mediator_t> lines;
+	lines.reserve(std::min<size_t>(max, 1024));
+	std::string line;
+	while (lines.size() < max && std::getline(fstr->stream, line))
+		lines.push_back(MAKE_STRING(std::move(line)));
+	return mediator_t(
+		MEDIATOR_ARRAY,
+		std::make_shared<std::vector<mediator_t>>(std::move(lines)));
+}
+
 ROSSA_EXT_SIG(_reader_read, args)
 {
-	auto fstr = COERCE_POINTER(args[0], std::ifstream);
+	auto fstr = COERCE_POINTER(args[0], lib_fs::reader_t);
 
-	size_t max = COERCE_NUMBER(args[1]).getLong();
+	size_t max = lib_fs::readSize(COERCE_NUMBER(args[1]).getLong());
 
-	std::string line = "";
-	char c;
-	for (size_t i = 0; i < max; i++)
-	{
-		if (fstr->get(c))
-			line += c;
-		else
-			break;
-	}
-	return MAKE_STRING(line);
+	std::string content;
+	lib_fs::readChunked(fstr->stream, content, max);
+	return MAKE_STRING(std::move(content));
+}
+
+ROSSA_EXT_SIG(_reader_readBytes, args)
+{
+	auto fstr = COERCE_POINTER(args[0], lib_fs::reader_t);
+
+	size_t max = lib_fs::readSize(COERCE_NUMBER(args[1]).getLong());
+
+	auto data = std::make_shared<std::vector<unsigned char>>();
+	lib_fs::readChunked(fstr->stream, *data, max);
+	return MAKE_POINTER(std::make_shared<bytes_t>(data, 0, data->size()));
+}
+
+ROSSA_EXT_SIG(_reader_readAll, args)
+{
+	auto fstr = COERCE_POINTER(args[0], lib_fs::reader_t);
+
+	auto pos = fstr->stream.tellg();
+	fstr->stream.seekg(0, std::ios::end);
+	auto end = fstr->stream.tellg();
+	fstr->stream.seekg(pos);
+
+	std::string content(end - pos, '\0');
+	fstr->stream.read(&content[0], content.size());
+	content.resize(fstr->stream.gcount());
+	return MAKE_STRING(std::move(content));
 }
 
 ROSSA_EXT_SIG(_reader_size, args)
 {
-	auto fstr = COERCE_POINTER(args[0], std::ifstream);
+	auto fstr = COERCE_POINTER(args[0], lib_fs::reader_t);
 
-	fstr->seekg(0, std::ios::end);
-	auto size = fstr->tellg();
-	fstr->seekg(0, std::ios::beg);
+	auto pos = fstr->stream.tellg();
+	fstr->stream.seekg(0, std::ios::end);
+	auto size = fstr->stream.tellg();
+	fstr->stream.seekg(pos);
 	return MAKE_NUMBER(number_t::Long(size));
 }
 
 ROSSA_EXT_SIG(_writer_write, args)
 {
-	auto fstr = COERCE_POINTER(args[0], std::ofstream);
+	auto fstr = COERCE_POINTER(args[0], lib_fs::writer_t);
 
-	*fstr << COERCE_STRING(args[1]);
+	auto &s = COERCE_STRING(args[1]);
+	fstr->stream.write(s.data(), s.size());
 	return mediator_t();
 }
 
+ROSSA_EXT_SIG(_writer_writeBytes, args)
+{
+	auto fstr = COERCE_POINTER(args[0], lib_fs::writer_t);
+	auto b = COERCE_POINTER(args[1], bytes_t);
+
+	fstr->stream.write(reinterpret_cast<const char *>(b->begin()), b->length);
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_writer_flush, args)
+{
+	auto fstr = COERCE_POINTER(args[0], lib_fs::writer_t);
+
+	fstr->stream.flush();
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_mapped_init, args)
+{
+	auto filename = COERCE_STRING(args[0]);
+
+	return MAKE_POINTER(std::make_shared<lib_fs::mapped_t>(filename));
+}
+
+ROSSA_EXT_SIG(_mapped_size, args)
+{
+	auto m = COERCE_POINTER(args[0], lib_fs::mapped_t);
+
+	return MAKE_NUMBER(number_t::Long(m->size));
+}
+
+ROSSA_EXT_SIG(_mapped_slice, args)
+{
+	auto m = COERCE_POINTER(args[0], lib_fs::mapped_t);
+	size_t start = COERCE_NUMBER(args[1]).getLong();
+	size_t length = COERCE_NUMBER(args[2]).getLong();
+
+	if (start > m->size)
+		start = m->size;
+	if (length > m->size - start)
+		length = m->size - start;
+	return MAKE_STRING(std::string(m->data + start, length));
+}
+
+ROSSA_EXT_SIG(_mapped_bytes, args)
+{
+	auto m = COERCE_POINTER(args[0], lib_fs::mapped_t);
+	size_t start = std::min<size_t>(COERCE_NUMBER(args[1]).getLong(), m->size);
+	size_t length = std::min<size_t>(COERCE_NUMBER(args[2]).getLong(), m->size - start);
+
+	auto b = std::make_shared<bytes_t>(length);
+	std::memcpy(b->begin(), m->data + start, length);
+	return MAKE_POINTER(b);
+}
+
+ROSSA_EXT_SIG(_mapped_string, args)
+{
+	auto m = COERCE_POINTER(args[0], lib_fs::mapped_t);
+
+	return MAKE_STRING(std::string(m->data, m->size));
+}
+
 ROSSA_EXT_SIG(_path_init, args)
 {
 	auto pathstr = COERCE_STRING(args[0]);
@@ -249,6 +573,58 @@ ROSSA_EXT_SIG(_path_unzip_b, args)
 	return mediator_t();
 }
 
+ROSSA_EXT_SIG(_path_zip_a, args)
+{
+	auto path1 = COERCE_POINTER(args[0], std::filesystem::path);
+	auto path2 = COERCE_POINTER(args[1], std::filesystem::path);
+
+	lib_fs::zip(*path1, *path2);
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_path_zip_b, args)
+{
+	auto path1 = COERCE_POINTER(args[0], std::filesystem::path);
+	auto path2 = COERCE_STRING(args[1]);
+
+	lib_fs::zip(*path1, path2);
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_path_zip_entries, args)
+{
+	auto path = COERCE_POINTER(args[0], std::filesystem::path);
+
+	auto z = lib_fs::openArchive(*path, ZIP_RDONLY);
+	zip_int64_t count = zip_get_num_entries(z.get(), 0);
+	std::vector<mediator_t> names;
+	names.reserve(count);
+	for (zip_int64_t i = 0; i < count; i++)
+	{
+		const char *name = zip_get_name(z.get(), i, 0);
+		if (name == NULL)
+			throw library_error_t("Error reading file within archive (possibly corrupt)");
+		names.push_back(MAKE_STRING(std::string(name)));
+	}
+	return mediator_t(
+		MEDIATOR_ARRAY,
+		std::make_shared<std::vector<mediator_t>>(std::move(names)));
+}
+
+ROSSA_EXT_SIG(_path_zip_readBytes, args)
+{
+	auto path = COERCE_POINTER(args[0], std::filesystem::path);
+
+	return MAKE_POINTER(lib_fs::readEntry(*path, COERCE_STRING(args[1])));
+}
+
+ROSSA_EXT_SIG(_path_zip_readString, args)
+{
+	auto path = COERCE_POINTER(args[0], std::filesystem::path);
+
+	return MAKE_STRING(lib_fs::readEntry(*path, COERCE_STRING(args[1]))->toString());
+}
+
 EXPORT_FUNCTIONS(lib_fs)
 {
 	ADD_EXT(_path_append_path);
@@ -264,11 +640,26 @@ EXPORT_FUNCTIONS(lib_fs)
 	ADD_EXT(_reader_size);
 	ADD_EXT(_reader_isOpen);
 	ADD_EXT(_reader_read);
+	ADD_EXT(_reader_readAll);
+	ADD_EXT(_reader_readBytes);
 	ADD_EXT(_reader_readLine);
+	ADD_EXT(_reader_readLines);
 	ADD_EXT(_writer_close);
+	ADD_EXT(_writer_flush);
 	ADD_EXT(_writer_init);
 	ADD_EXT(_writer_isOpen);
 	ADD_EXT(_writer_write);
+	ADD_EXT(_writer_writeBytes);
+	ADD_EXT(_mapped_bytes);
+	ADD_EXT(_mapped_init);
+	ADD_EXT(_mapped_size);
+	ADD_EXT(_mapped_slice);
+	ADD_EXT(_mapped_string);
 	ADD_EXT(_path_unzip_a);
 	ADD_EXT(_path_unzip_b);
+	ADD_EXT(_path_zip_a);
+	ADD_EXT(_path_zip_b);
+	ADD_EXT(_path_zip_entries);
+	ADD_EXT(_path_zip_readBytes);
+	ADD_EXT(_path_zip_readString);
 }
\ No newline at end of file
@@ -1,70 +1,437 @@
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <iostream>
+#include <sstream>
+#include <deque>
 #include "encode.h"
 #include "../main/mediator/mediator.h"
+#include "../main/mediator/bytes.h"
+
+#define SOCKET_READ_CHUNK 65536
+
+namespace lib_net
+{
+	// An io_service plus the completions it has produced since Rossa last collected them
+	struct service_t
+	{
+		boost::asio::io_service io;
+		std::vector<mediator_t> events;
+
+		// Queues `[id, value, error]` for the dispatcher in net.ra
+		inline void complete(const long_int_t &id, const mediator_t &value, const boost::system::error_code &ec)
+		{
+			events.push_back(mediator_t(
+				MEDIATOR_ARRAY,
+				std::make_shared<std::vector<mediator_t>>(std::vector<mediator_t>{
+					MAKE_NUMBER(number_t::Long(id)),
+					value,
+					ec ? MAKE_STRING(ec.message()) : mediator_t()})));
+		}
+	};
+
+	// A connected socket plus the bytes received beyond the last read; `read_until` may pull in more than one message, and the rest waits here for the next read
+	struct socket_t
+	{
+		boost::asio::ip::tcp::socket sock;
+		boost::asio::streambuf buffer;
+
+		socket_t(boost::asio::io_service &io)
+			: sock(io)
+		{
+		}
+
+		// Hands the first `n` buffered bytes to Rossa as a string; the buffer's storage is reused by the next read
+		inline const mediator_t take(const size_t &n)
+		{
+			auto str = std::make_shared<std::string>(static_cast<const char *>(buffer.data().data()), n);
+			buffer.consume(n);
+			return mediator_t(MEDIATOR_STRING, str);
+		}
+	};
+
+	inline size_t readSize(const long_int_t &size)
+	{
+		if (size < 0)
+			throw library_error_t("Read size cannot be negative");
+		return static_cast<size_t>(size);
+	}
+
+	namespace http = boost::beast::http;
+
+	inline const std::string fromView(const boost::beast::string_view &s)
+	{
+		return std::string(s.data(), s.size());
+	}
+
+	// Headers are only turned into a Dictionary when a script asks for all of them
+	inline const mediator_t fieldsToDictionary(const http::fields &fields)
+	{
+		std::map<const std::string, const mediator_t> ret;
+		for (auto &f : fields)
+			ret.insert({fromView(f.name_string()), MAKE_STRING(fromView(f.value()))});
+		return MAKE_DICTIONARY(ret);
+	}
+
+	template <class Message>
+	inline void setFields(Message &m, const std::map<const std::string, const mediator_t> &fields)
+	{
+		for (auto &f : fields)
+			m.set(f.first, COERCE_STRING(f.second));
+	}
+
+	// One keep-alive connection accepted by an HTTP server; requests are read one at a time, so pipelined ones wait in `buffer` until the previous response is written
+	struct http_conn_t : public std::enable_shared_from_this<http_conn_t>
+	{
+		boost::beast::tcp_stream stream;
+		boost::beast::flat_buffer buffer;
+		http::request<http::string_body> request;
+		service_t *service;
+		const long_int_t id;
+		// Pieces of a chunked response still to be written, oldest first; only the front is being written
+		std::deque<std::string> outbox;
+		bool writing = false;
+		bool ending = false;
+		bool keepAlive = false;
+		boost::system::error_code failure;
+
+		http_conn_t(boost::asio::ip::tcp::socket &&sock, service_t *service, const long_int_t &id)
+			: stream(std::move(sock)), service{service}, id{id}
+		{
+		}
+
+		// Queues raw response bytes behind whatever is still being written
+		void write(std::string &&data)
+		{
+			if (failure)
+				throw library_error_t(failure.message());
+			outbox.push_back(std::move(data));
+			if (!writing)
+				flush();
+		}
+
+		// Finishes the response once the queue has drained
+		void end(const bool &keepAlive)
+		{
+			ending = true;
+			this->keepAlive = keepAlive;
+			if (!writing)
+				flush();
+		}
+
+		void flush()
+		{
+			if (outbox.empty())
+			{
+				writing = false;
+				if (ending)
+				{
+					ending = false;
+					finish(keepAlive && !failure);
+				}
+				return;
+			}
+			writing = true;
+			auto self = shared_from_this();
+			boost::asio::async_write(stream, boost::asio::buffer(outbox.front()), [self](const boost::system::error_code &ec, size_t) {
+				self->outbox.pop_front();
+				if (ec)
+				{
+					self->failure = ec;
+					self->outbox.clear();
+				}
+				self->flush();
+			});
+		}
+
+		// A connection that fails or is closed by the peer is dropped without reaching Rossa
+		void next()
+		{
+			request = {};
+			auto self = shared_from_this();
+			http::async_read(stream, buffer, request, [self](const boost::system::error_code &ec, size_t) {
+				if (ec)
+					return self->close();
+				self->service->complete(self->id, MAKE_POINTER(self), ec);
+			});
+		}
+
+		void finish(const bool &keepAlive)
+		{
+			if (keepAlive)
+				next();
+			else
+				close();
+		}
+
+		void close()
+		{
+			boost::system::error_code ec;
+			stream.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+			stream.close();
+		}
+	};
+
+	// Accepts continuously, reporting every parsed request under the same handler id
+	struct http_server_t : public std::enable_shared_from_this<http_server_t>
+	{
+		boost::asio::ip::tcp::acceptor acceptor;
+		service_t *service;
+		const long_int_t id;
+
+		http_server_t(service_t *service, const unsigned short &port, const long_int_t &id)
+			: acceptor(service->io, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)), service{service}, id{id}
+		{
+		}
+
+		void accept()
+		{
+			auto self = shared_from_this();
+			acceptor.async_accept([self](const boost::system::error_code &ec, boost::asio::ip::tcp::socket sock) {
+				if (ec == boost::asio::error::operation_aborted)
+					return;
+				if (ec)
+					self->service->complete(self->id, mediator_t(), ec);
+				else
+					std::make_shared<http_conn_t>(std::move(sock), self->service, self->id)->next();
+				self->accept();
+			});
+		}
+	};
+
+	// A pooled client connection
+	struct http_link_t
+	{
+		boost::beast::tcp_stream stream;
+		boost::beast::flat_buffer buffer;
+		const std::string key;
+
+		http_link_t(boost::asio::io_service &io, const std::string &key)
+			: stream(io), key{key}
+		{
+		}
+	};
+
+	// Keeps idle keep-alive connections per `host:port` so consecutive requests skip the connect
+	struct http_client_t
+	{
+		boost::asio::io_service io;
+		boost::asio::ip::tcp::resolver resolver;
+		std::map<std::string, std::vector<std::shared_ptr<http_link_t>>> idle;
+
+		http_client_t()
+			: resolver(io)
+		{
+		}
+
+		const std::shared_ptr<http_link_t> acquire(const std::string &host, const std::string &port, bool &pooled)
+		{
+			auto &links = idle[host + ":" + port];
+			pooled = !links.empty();
+			if (pooled)
+			{
+				auto link = links.back();
+				links.pop_back();
+				return link;
+			}
+			auto link = std::make_shared<http_link_t>(io, host + ":" + port);
+			boost::system::error_code ec;
+			auto results = resolver.resolve(host, port, ec);
+			if (!ec)
+				link->stream.connect(results, ec);
+			if (ec)
+				throw library_error_t(ec.message());
+			return link;
+		}
+	};
+
+	// A response whose headers have been read; the body is pulled on demand so large bodies can be streamed
+	struct http_reply_t
+	{
+		std::shared_ptr<http_client_t> client;
+		std::shared_ptr<http_link_t> link;
+		http::response_parser<http::buffer_body> parser;
+
+		// Up to `max` more body bytes, empty once the body is complete; the connection returns to the pool as soon as it is
+		const std::string read(const size_t &max)
+		{
+			std::string out;
+			while (link != nullptr && out.size() < max && !parser.is_done())
+			{
+				const size_t at = out.size();
+				const size_t n = std::min<size_t>(max - at, SOCKET_READ_CHUNK);
+				out.resize(at + n);
+				parser.get().body().data = &out[at];
+				parser.get().body().size = n;
+				boost::system::error_code ec;
+				http::read(link->stream, link->buffer, parser, ec);
+				if (ec == http::error::need_buffer)
+					ec = {};
+				if (ec)
+					throw library_error_t(ec.message());
+				out.resize(at + n - parser.get().body().size);
+			}
+			if (link != nullptr && parser.is_done())
+			{
+				if (parser.get().keep_alive())
+					client->idle[link->key].push_back(link);
+				link = nullptr;
+			}
+			return out;
+		}
+	};
+}
 
 ROSSA_EXT_SIG(_service_init, args)
 {
-	auto service = std::make_shared<boost::asio::io_service>();
+	auto service = std::make_shared<lib_net::service_t>();
 	return MAKE_POINTER(service);
 }
 
+// Blocks until at least one asynchronous operation completes, then returns every completion that is ready; nil once no work is left
+ROSSA_EXT_SIG(_service_run, args)
+{
+	auto service = COERCE_POINTER(args[0], lib_net::service_t);
+
+	if (service->events.empty())
+	{
+		if (service->io.stopped())
+			service->io.restart();
+		if (service->io.run_one() == 0)
+			return mediator_t();
+	}
+	service->io.poll();
+
+	auto events = std::make_shared<std::vector<mediator_t>>();
+	events->swap(service->events);
+	return mediator_t(MEDIATOR_ARRAY, events);
+}
+
 ROSSA_EXT_SIG(_socket_init, args)
 {
-	auto io_service_object = COERCE_POINTER(args[2], boost::asio::io_service);
+	auto service = COERCE_POINTER(args[2], lib_net::service_t);
 
-	auto sock = std::make_shared<boost::asio::ip::tcp::socket>(*io_service_object);
+	auto s = std::make_shared<lib_net::socket_t>(service->io);
 	boost::system::error_code ec;
-	if (sock->connect(
+	if (s->sock.connect(
 			boost::asio::ip::tcp::endpoint(
 				boost::asio::ip::address::from_string(COERCE_STRING(args[0])),
 				COERCE_NUMBER(args[1]).getLong()),
 			ec))
 		if (ec)
 			throw library_error_t(ec.message());
-	return MAKE_POINTER(sock);
+	return MAKE_POINTER(s);
 }
 
 ROSSA_EXT_SIG(_socket_send, args)
 {
-	auto sock = COERCE_POINTER(args[0], boost::asio::ip::tcp::socket);
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
 
 	std::string content = COERCE_STRING(args[1]);
-	boost::asio::write(*sock, boost::asio::buffer(content));
+	boost::asio::write(s->sock, boost::asio::buffer(content));
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_socket_sendBytes, args)
+{
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
+	auto b = COERCE_POINTER(args[1], bytes_t);
+
+	boost::asio::write(s->sock, boost::asio::buffer(b->begin(), b->length));
 	return mediator_t();
 }
 
+// Buffered bytes are copied out first, the remainder is read straight into the Bytes storage a chunk at a time
+ROSSA_EXT_SIG(_socket_readBytes, args)
+{
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
+	const size_t max = lib_net::readSize(COERCE_NUMBER(args[1]).getLong());
+
+	auto data = std::make_shared<std::vector<unsigned char>>(std::min(s->buffer.size(), max));
+	std::memcpy(data->data(), s->buffer.data().data(), data->size());
+	s->buffer.consume(data->size());
+
+	boost::system::error_code ec;
+	while (data->size() < max && !ec)
+	{
+		const size_t at = data->size();
+		data->resize(at + std::min<size_t>(max - at, SOCKET_READ_CHUNK));
+		data->resize(at + boost::asio::read(s->sock, boost::asio::buffer(data->data() + at, data->size() - at), ec));
+	}
+	if (ec && ec != boost::asio::error::eof)
+		throw library_error_t(ec.message());
+	return MAKE_POINTER(std::make_shared<bytes_t>(data, 0, data->size()));
+}
+
+// Everything until the peer closes the connection
 ROSSA_EXT_SIG(_socket_read, args)
 {
-	auto sock = COERCE_POINTER(args[0], boost::asio::ip::tcp::socket);
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
 
-	boost::asio::streambuf sb;
 	boost::system::error_code ec;
-	boost::asio::read(*sock, sb, ec);
-	std::string str(boost::asio::buffers_begin(sb.data()), boost::asio::buffers_begin(sb.data()) + sb.data().size());
-	return MAKE_STRING(str);
+	boost::asio::read(s->sock, s->buffer, ec);
+	if (ec && ec != boost::asio::error::eof)
+		throw library_error_t(ec.message());
+	return s->take(s->buffer.size());
 }
 
 ROSSA_EXT_SIG(_socket_read_until, args)
 {
-	auto sock = COERCE_POINTER(args[0], boost::asio::ip::tcp::socket);
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
+
+	boost::system::error_code ec;
+	size_t n = boost::asio::read_until(s->sock, s->buffer, COERCE_STRING(args[1]), ec);
+	if (ec == boost::asio::error::eof)
+		return mediator_t();
+	if (ec)
+		throw library_error_t(ec.message());
+	return s->take(n);
+}
+
+// Exactly `n` bytes, or whatever arrived before the peer closed; nil at end of stream
+ROSSA_EXT_SIG(_socket_readN, args)
+{
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
+	size_t n = lib_net::readSize(COERCE_NUMBER(args[1]).getLong());
 
-	boost::asio::streambuf sb;
-	if (boost::asio::read_until(*sock, sb, COERCE_STRING(args[1])))
+	if (s->buffer.size() < n)
 	{
-		std::string str(boost::asio::buffers_begin(sb.data()), boost::asio::buffers_begin(sb.data()) + sb.data().size());
-		return MAKE_STRING(str);
+		boost::system::error_code ec;
+		boost::asio::read(s->sock, s->buffer, boost::asio::transfer_exactly(n - s->buffer.size()), ec);
+		if (ec && ec != boost::asio::error::eof)
+			throw library_error_t(ec.message());
+		n = std::min(n, s->buffer.size());
 	}
-	return mediator_t();
+	if (n == 0)
+		return mediator_t();
+	return s->take(n);
+}
+
+// Whatever is buffered or already waiting on the socket, blocking only when both are empty; nil at end of stream
+ROSSA_EXT_SIG(_socket_readAvailable, args)
+{
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
+
+	boost::system::error_code ec;
+	if (s->buffer.size() == 0)
+	{
+		s->buffer.commit(s->sock.read_some(s->buffer.prepare(SOCKET_READ_CHUNK), ec));
+		if (ec && ec != boost::asio::error::eof)
+			throw library_error_t(ec.message());
+	}
+	size_t waiting = s->sock.available(ec);
+	if (!ec && waiting > 0)
+		s->buffer.commit(s->sock.read_some(s->buffer.prepare(waiting), ec));
+	if (s->buffer.size() == 0)
+		return mediator_t();
+	return s->take(s->buffer.size());
 }
 
 ROSSA_EXT_SIG(_socket_close, args)
 {
-	auto sock = COERCE_POINTER(args[0], boost::asio::ip::tcp::socket);
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
 
 	boost::system::error_code ec;
-	sock->close(ec);
+	s->sock.close(ec);
 	if (ec)
 		return MAKE_STRING(ec.message());
 	return mediator_t();
@@ -72,32 +439,99 @@ ROSSA_EXT_SIG(_socket_close, args)
 
 ROSSA_EXT_SIG(_server_init, args)
 {
-	auto io_service_object = COERCE_POINTER(args[1], boost::asio::io_service);
+	auto service = COERCE_POINTER(args[1], lib_net::service_t);
 
-	auto acc = std::make_shared<boost::asio::ip::tcp::acceptor>(*io_service_object, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), COERCE_NUMBER(args[0]).getLong()));
+	auto acc = std::make_shared<boost::asio::ip::tcp::acceptor>(service->io, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), COERCE_NUMBER(args[0]).getLong()));
 	return MAKE_POINTER(acc);
 }
 
 ROSSA_EXT_SIG(_server_accept, args)
 {
 	auto acc = COERCE_POINTER(args[0], boost::asio::ip::tcp::acceptor);
-	auto io_service_object = COERCE_POINTER(args[1], boost::asio::io_service);
+	auto service = COERCE_POINTER(args[1], lib_net::service_t);
+
+	auto s = std::make_shared<lib_net::socket_t>(service->io);
+	acc->accept(s->sock);
+	return MAKE_POINTER(s);
+}
+
+ROSSA_EXT_SIG(_server_acceptAsync, args)
+{
+	auto acc = COERCE_POINTER(args[0], boost::asio::ip::tcp::acceptor);
+	auto service = COERCE_POINTER(args[1], lib_net::service_t);
+	auto id = COERCE_NUMBER(args[2]).getLong();
+
+	auto s = std::make_shared<lib_net::socket_t>(service->io);
+	lib_net::service_t *srv = service.get();
+	acc->async_accept(s->sock, [acc, s, srv, id](const boost::system::error_code &ec) {
+		srv->complete(id, ec ? mediator_t() : MAKE_POINTER(s), ec);
+	});
+	return mediator_t();
+}
+
+// Up to `max` bytes, capped at one read chunk; served from the socket's buffer when it already holds data
+ROSSA_EXT_SIG(_socket_readAsync, args)
+{
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
+	const size_t max = std::min<size_t>(lib_net::readSize(COERCE_NUMBER(args[1]).getLong()), SOCKET_READ_CHUNK);
+	auto service = COERCE_POINTER(args[2], lib_net::service_t);
+	auto id = COERCE_NUMBER(args[3]).getLong();
+
+	lib_net::service_t *srv = service.get();
+	if (s->buffer.size() > 0)
+	{
+		boost::asio::post(srv->io, [s, max, srv, id]() {
+			srv->complete(id, s->take(std::min(max, s->buffer.size())), boost::system::error_code());
+		});
+		return mediator_t();
+	}
+	s->sock.async_read_some(s->buffer.prepare(max), [s, srv, id](const boost::system::error_code &ec, size_t n) {
+		s->buffer.commit(n);
+		srv->complete(id, n > 0 ? s->take(n) : mediator_t(), ec);
+	});
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_socket_read_untilAsync, args)
+{
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
+	auto delim = COERCE_STRING(args[1]);
+	auto service = COERCE_POINTER(args[2], lib_net::service_t);
+	auto id = COERCE_NUMBER(args[3]).getLong();
+
+	lib_net::service_t *srv = service.get();
+	boost::asio::async_read_until(s->sock, s->buffer, delim, [s, srv, id](const boost::system::error_code &ec, size_t n) {
+		if (ec)
+			return srv->complete(id, mediator_t(), ec);
+		srv->complete(id, s->take(n), ec);
+	});
+	return mediator_t();
+}
 
-	auto sock = std::make_shared<boost::asio::ip::tcp::socket>(*io_service_object);
-	acc->accept(*sock);
-	return MAKE_POINTER(sock);
+ROSSA_EXT_SIG(_socket_sendAsync, args)
+{
+	auto s = COERCE_POINTER(args[0], lib_net::socket_t);
+	auto data = std::make_shared<std::string>(COERCE_STRING(args[1]));
+	auto service = COERCE_POINTER(args[2], lib_net::service_t);
+	auto id = COERCE_NUMBER(args[3]).getLong();
+
+	lib_net::service_t *srv = service.get();
+	boost::asio::async_write(s->sock, boost::asio::buffer(*data), [s, data, srv, id](const boost::system::error_code &ec, size_t n) {
+		srv->complete(id, MAKE_NUMBER(number_t::Long(n)), ec);
+	});
+	return mediator_t();
 }
 
 ROSSA_EXT_SIG(_tcp_stream_init, args)
 {
 	const std::string address = COERCE_STRING(args[0]);
 	const std::string port = std::to_string(COERCE_NUMBER(args[1]).getLong());
-	auto io_service_object = COERCE_POINTER(args[2], boost::asio::io_service);
+	auto service = COERCE_POINTER(args[2], lib_net::service_t);
 
-	boost::asio::ip::tcp::resolver resolver(*io_service_object);
+	boost::asio::ip::tcp::resolver resolver(service->io);
 	auto results = resolver.resolve(address, port);
 
-	auto tcpstream = std::make_shared<boost::beast::tcp_stream>(*io_service_object);
+	auto tcpstream = std::make_shared<boost::beast::tcp_stream>(service->io);
 	boost::system::error_code ec;
 	tcpstream->connect(results);
 
@@ -149,6 +583,217 @@ ROSSA_EXT_SIG(_tcp_stream_close, args)
 	return mediator_t();
 }
 
+ROSSA_EXT_SIG(_http_server_init, args)
+{
+	auto service = COERCE_POINTER(args[1], lib_net::service_t);
+
+	try
+	{
+		auto server = std::make_shared<lib_net::http_server_t>(service.get(), COERCE_NUMBER(args[0]).getLong(), COERCE_NUMBER(args[2]).getLong());
+		server->accept();
+		return MAKE_POINTER(server);
+	}
+	catch (const boost::system::system_error &e)
+	{
+		throw library_error_t(e.code().message());
+	}
+}
+
+ROSSA_EXT_SIG(_http_server_close, args)
+{
+	auto server = COERCE_POINTER(args[0], lib_net::http_server_t);
+
+	boost::system::error_code ec;
+	server->acceptor.close(ec);
+	return mediator_t();
+}
+
+// `[method, path, query]` of the request waiting on a connection
+ROSSA_EXT_SIG(_http_request_line, args)
+{
+	auto conn = COERCE_POINTER(args[0], lib_net::http_conn_t);
+
+	const std::string target = lib_net::fromView(conn->request.target());
+	const size_t q = target.find('?');
+	return mediator_t(
+		MEDIATOR_ARRAY,
+		std::make_shared<std::vector<mediator_t>>(std::vector<mediator_t>{
+			MAKE_STRING(lib_net::fromView(conn->request.method_string())),
+			MAKE_STRING(target.substr(0, q)),
+			q == std::string::npos ? MAKE_STRING("") : MAKE_STRING(target.substr(q + 1))}));
+}
+
+ROSSA_EXT_SIG(_http_request_header, args)
+{
+	auto conn = COERCE_POINTER(args[0], lib_net::http_conn_t);
+
+	auto it = conn->request.find(COERCE_STRING(args[1]));
+	if (it == conn->request.end())
+		return mediator_t();
+	return MAKE_STRING(lib_net::fromView(it->value()));
+}
+
+ROSSA_EXT_SIG(_http_request_headers, args)
+{
+	auto conn = COERCE_POINTER(args[0], lib_net::http_conn_t);
+
+	return lib_net::fieldsToDictionary(conn->request.base());
+}
+
+ROSSA_EXT_SIG(_http_request_body, args)
+{
+	auto conn = COERCE_POINTER(args[0], lib_net::http_conn_t);
+
+	return MAKE_STRING(conn->request.body());
+}
+
+// Writes a complete response, then goes back to reading the connection if both sides keep it alive
+ROSSA_EXT_SIG(_http_respond, args)
+{
+	auto conn = COERCE_POINTER(args[0], lib_net::http_conn_t);
+
+	auto res = std::make_shared<lib_net::http::response<lib_net::http::string_body>>(static_cast<lib_net::http::status>(COERCE_NUMBER(args[1]).getLong()), conn->request.version());
+	lib_net::setFields(*res, COERCE_DICTIONARY(args[2]));
+	res->body() = COERCE_STRING(args[3]);
+	res->keep_alive(conn->request.keep_alive());
+	res->prepare_payload();
+
+	lib_net::http::async_write(conn->stream, *res, [conn, res](const boost::system::error_code &ec, size_t) {
+		conn->finish(!ec && res->keep_alive());
+	});
+	return mediator_t();
+}
+
+// The header and every chunk go through the connection's write queue, so a slow peer never blocks the service loop
+ROSSA_EXT_SIG(_http_respondChunked, args)
+{
+	auto conn = COERCE_POINTER(args[0], lib_net::http_conn_t);
+
+	lib_net::http::response<lib_net::http::empty_body> res(static_cast<lib_net::http::status>(COERCE_NUMBER(args[1]).getLong()), conn->request.version());
+	lib_net::setFields(res, COERCE_DICTIONARY(args[2]));
+	res.keep_alive(conn->request.keep_alive());
+	res.chunked(true);
+
+	std::ostringstream header;
+	header << res.base();
+	conn->write(header.str());
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_http_writeChunk, args)
+{
+	auto conn = COERCE_POINTER(args[0], lib_net::http_conn_t);
+
+	const std::string data = COERCE_STRING(args[1]);
+	if (data.empty())
+		return mediator_t();
+	std::ostringstream chunk;
+	chunk << std::hex << data.size() << "\r\n"
+		  << data << "\r\n";
+	conn->write(chunk.str());
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_http_endChunked, args)
+{
+	auto conn = COERCE_POINTER(args[0], lib_net::http_conn_t);
+
+	if (!conn->failure)
+		conn->write("0\r\n\r\n");
+	conn->end(conn->request.keep_alive());
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_http_client_init, args)
+{
+	auto client = std::make_shared<lib_net::http_client_t>();
+	return MAKE_POINTER(client);
+}
+
+// Sends a request on a pooled connection and reads the response headers; a pooled connection the server has since closed is replaced once
+ROSSA_EXT_SIG(_http_client_request, args)
+{
+	auto client = COERCE_POINTER(args[0], lib_net::http_client_t);
+	const std::string method = COERCE_STRING(args[1]);
+	const std::string host = COERCE_STRING(args[2]);
+	const std::string port = std::to_string(COERCE_NUMBER(args[3]).getLong());
+
+	const auto verb = lib_net::http::string_to_verb(method);
+	if (verb == lib_net::http::verb::unknown)
+		throw library_error_t("Unknown HTTP method: " + method);
+
+	lib_net::http::request<lib_net::http::string_body> req(verb, COERCE_STRING(args[4]), 11);
+	req.set(lib_net::http::field::host, host);
+	lib_net::setFields(req, COERCE_DICTIONARY(args[5]));
+	req.body() = COERCE_STRING(args[6]);
+	req.keep_alive(true);
+	req.prepare_payload();
+
+	auto reply = std::make_shared<lib_net::http_reply_t>();
+	reply->client = client;
+	reply->parser.body_limit(std::numeric_limits<std::uint64_t>::max());
+
+	bool pooled;
+	boost::system::error_code ec;
+	do
+	{
+		reply->link = client->acquire(host, port, pooled);
+		lib_net::http::write(reply->link->stream, req, ec);
+		if (!ec)
+			lib_net::http::read_header(reply->link->stream, reply->link->buffer, reply->parser, ec);
+	} while (ec && pooled);
+	if (ec)
+		throw library_error_t(ec.message());
+	return MAKE_POINTER(reply);
+}
+
+ROSSA_EXT_SIG(_http_reply_status, args)
+{
+	auto reply = COERCE_POINTER(args[0], lib_net::http_reply_t);
+
+	return MAKE_NUMBER(number_t::Long(reply->parser.get().result_int()));
+}
+
+ROSSA_EXT_SIG(_http_reply_header, args)
+{
+	auto reply = COERCE_POINTER(args[0], lib_net::http_reply_t);
+
+	auto it = reply->parser.get().find(COERCE_STRING(args[1]));
+	if (it == reply->parser.get().end())
+		return mediator_t();
+	return MAKE_STRING(lib_net::fromView(it->value()));
+}
+
+ROSSA_EXT_SIG(_http_reply_headers, args)
+{
+	auto reply = COERCE_POINTER(args[0], lib_net::http_reply_t);
+
+	return lib_net::fieldsToDictionary(reply->parser.get().base());
+}
+
+// Next piece of the body, nil once it has been read completely
+ROSSA_EXT_SIG(_http_reply_read, args)
+{
+	auto reply = COERCE_POINTER(args[0], lib_net::http_reply_t);
+
+	if (reply->link == nullptr)
+		return mediator_t();
+	const std::string data = reply->read(lib_net::readSize(COERCE_NUMBER(args[1]).getLong()));
+	if (data.empty())
+		return mediator_t();
+	return MAKE_STRING(data);
+}
+
+ROSSA_EXT_SIG(_http_reply_readAll, args)
+{
+	auto reply = COERCE_POINTER(args[0], lib_net::http_reply_t);
+
+	std::string body;
+	while (reply->link != nullptr)
+		body += reply->read(SOCKET_READ_CHUNK);
+	return MAKE_STRING(body);
+}
+
 ROSSA_EXT_SIG(_encodeURI, args)
 {
 	const std::string s = COERCE_STRING(args[0]);
@@ -165,14 +810,40 @@ EXPORT_FUNCTIONS(lib_net)
 {
 	ADD_EXT(_decodeURI);
 	ADD_EXT(_encodeURI);
+	ADD_EXT(_http_client_init);
+	ADD_EXT(_http_client_request);
+	ADD_EXT(_http_endChunked);
+	ADD_EXT(_http_reply_header);
+	ADD_EXT(_http_reply_headers);
+	ADD_EXT(_http_reply_read);
+	ADD_EXT(_http_reply_readAll);
+	ADD_EXT(_http_reply_status);
+	ADD_EXT(_http_request_body);
+	ADD_EXT(_http_request_header);
+	ADD_EXT(_http_request_headers);
+	ADD_EXT(_http_request_line);
+	ADD_EXT(_http_respond);
+	ADD_EXT(_http_respondChunked);
+	ADD_EXT(_http_server_close);
+	ADD_EXT(_http_server_init);
+	ADD_EXT(_http_writeChunk);
 	ADD_EXT(_server_accept);
+	ADD_EXT(_server_acceptAsync);
 	ADD_EXT(_server_init);
 	ADD_EXT(_service_init);
+	ADD_EXT(_service_run);
 	ADD_EXT(_socket_close);
 	ADD_EXT(_socket_init);
 	ADD_EXT(_socket_read_until);
+	ADD_EXT(_socket_read_untilAsync);
 	ADD_EXT(_socket_read);
+	ADD_EXT(_socket_readAsync);
+	ADD_EXT(_socket_readAvailable);
+	ADD_EXT(_socket_readBytes);
+	ADD_EXT(_socket_readN);
 	ADD_EXT(_socket_send);
+	ADD_EXT(_socket_sendAsync);
+	ADD_EXT(_socket_sendBytes);
 	ADD_EXT(_tcp_stream_close);
 	ADD_EXT(_tcp_stream_init);
 	ADD_EXT(_tcp_stream_request);
@@ -1,4 +1,5 @@
 #include "../main/mediator/mediator.h"
+#include "../main/mediator/bytes.h"
 
 #include <random>
 #include <regex>
@@ -372,11 +373,103 @@ ROSSA_EXT_SIG(_function_split, args, token, hash, stack_trace)
 }
 */
 
+namespace lib_standard
+{
+	inline void checkBytes(const bytes_t &b, const long_int_t &at, const long_int_t &width)
+	{
+		if (width < 1 || width > 8)
+			throw library_error_t("Integer width must be between 1 and 8 bytes");
+		if (at < 0 || static_cast<size_t>(width) > b.length || static_cast<size_t>(at) > b.length - width)
+			throw library_error_t("Byte offset out of bounds");
+	}
+}
+
+ROSSA_EXT_SIG(_bytes_init, args)
+{
+	auto size = COERCE_NUMBER(args[0]).getLong();
+	if (size < 0)
+		throw library_error_t("Byte buffer size cannot be negative");
+
+	return MAKE_POINTER(std::make_shared<bytes_t>(size));
+}
+
+ROSSA_EXT_SIG(_bytes_fromString, args)
+{
+	return MAKE_POINTER(std::make_shared<bytes_t>(COERCE_STRING(args[0])));
+}
+
+ROSSA_EXT_SIG(_bytes_toString, args)
+{
+	auto b = COERCE_POINTER(args[0], bytes_t);
+
+	return MAKE_STRING(b->toString());
+}
+
+ROSSA_EXT_SIG(_bytes_size, args)
+{
+	auto b = COERCE_POINTER(args[0], bytes_t);
+
+	return MAKE_NUMBER(number_t::Long(b->length));
+}
+
+ROSSA_EXT_SIG(_bytes_slice, args)
+{
+	auto b = COERCE_POINTER(args[0], bytes_t);
+	auto start = COERCE_NUMBER(args[1]).getLong();
+	auto count = COERCE_NUMBER(args[2]).getLong();
+
+	return MAKE_POINTER(std::make_shared<bytes_t>(b->slice(std::max<long_int_t>(start, 0), std::max<long_int_t>(count, 0))));
+}
+
+ROSSA_EXT_SIG(_bytes_readInt, args)
+{
+	auto b = COERCE_POINTER(args[0], bytes_t);
+	auto at = COERCE_NUMBER(args[1]).getLong();
+	auto width = COERCE_NUMBER(args[2]).getLong();
+	lib_standard::checkBytes(*b, at, width);
+
+	unsigned long long v = b->readInt(at, width, COERCE_BOOLEAN(args[3]));
+	if (COERCE_BOOLEAN(args[4]) && width < 8 && (v >> (8 * width - 1)) & 1)
+		v |= ~0ULL << (8 * width);
+	return MAKE_NUMBER(number_t::Long(static_cast<long_int_t>(v)));
+}
+
+ROSSA_EXT_SIG(_bytes_writeInt, args)
+{
+	auto b = COERCE_POINTER(args[0], bytes_t);
+	auto at = COERCE_NUMBER(args[1]).getLong();
+	auto width = COERCE_NUMBER(args[2]).getLong();
+	lib_standard::checkBytes(*b, at, width);
+
+	b->writeInt(at, width, static_cast<unsigned long long>(COERCE_NUMBER(args[3]).getLong()), COERCE_BOOLEAN(args[4]));
+	return mediator_t();
+}
+
+ROSSA_EXT_SIG(_bytes_copy, args)
+{
+	auto dst = COERCE_POINTER(args[0], bytes_t);
+	auto at = COERCE_NUMBER(args[1]).getLong();
+	auto src = COERCE_POINTER(args[2], bytes_t);
+	if (at < 0 || static_cast<size_t>(at) + src->length > dst->length)
+		throw library_error_t("Byte offset out of bounds");
+
+	std::memmove(dst->begin() + at, src->begin(), src->length);
+	return mediator_t();
+}
+
 EXPORT_FUNCTIONS(lib_standard)
 {
 	ADD_EXT(_acos);
 	ADD_EXT(_asin);
 	ADD_EXT(_atan);
+	ADD_EXT(_bytes_copy);
+	ADD_EXT(_bytes_fromString);
+	ADD_EXT(_bytes_init);
+	ADD_EXT(_bytes_readInt);
+	ADD_EXT(_bytes_size);
+	ADD_EXT(_bytes_slice);
+	ADD_EXT(_bytes_toString);
+	ADD_EXT(_bytes_writeInt);
 	ADD_EXT(_acosh);
 	ADD_EXT(_asinh);
 	ADD_EXT(_atanh);
@@ -1,10 +1,11 @@
 #include <iostream>
-#include <fstream>
 
 #include "rossa/rossa.h"
 #include "rossa/parser/parser.h"
 #include "rossa/symbol/symbol.h"
 #include "rossa/function/function.h"
+#include "rossa/global/global.h"
+#include "rossa/stats/stats.h"
 
 inline const std::pair<std::map<std::string, std::string>, std::vector<std::string>> parseOptions(int argc, char const *argv[])
 {
@@ -13,7 +14,10 @@ inline const std::pair<std::map<std::string, std::string>, std::vector<std::stri
 		{"version", "false"},
 		{"standard", "true"},
 		{"file", ""},
-		{"output", ""}};
+		{"output", ""},
+		{"stats", ""},
+		{"optimize", "1"},
+		{"max-depth", "0"}};
 	std::vector<std::string> passed;
 
 	bool flag = false;
@@ -30,6 +34,14 @@ inline const std::pair<std::map<std::string, std::string>, std::vector<std::stri
 				options["version"] = "true";
 			else if (std::string(argv[i]) == "--output" || std::string(argv[i]) == "-o")
 				options["output"] = argv[++i];
+			else if (std::string(argv[i]) == "--stats" || std::string(argv[i]) == "-s")
+				options["stats"] = "text";
+			else if (std::string(argv[i]) == "--stats-json")
+				options["stats"] = "json";
+			else if (std::string(argv[i]) == "-O0" || std::string(argv[i]) == "-O1" || std::string(argv[i]) == "-O2")
+				options["optimize"] = std::string(argv[i]).substr(2);
+			else if (std::string(argv[i]) == "--max-depth" || std::string(argv[i]) == "-md")
+				options["max-depth"] = argv[++i];
 			else
 			{
 				std::cerr << "Unknown command line option: " << argv[i] << "\n";
@@ -57,6 +69,10 @@ int main(int argc, char const *argv[])
 		std::cout << _ROSSA_VERSION_LONG_ << "\n";
 		return 0;
 	}
+	if (options["stats"] != "")
+		stats::enable(options["stats"] == "json");
+	parser_t::optLevel = std::stoi(options["optimize"]);
+	parser_t::maxDepth = std::stoul(options["max-depth"]);
 	parser_t wrapper(parsed.second);
 
 	printc("", RESET_TEXT);
@@ -87,7 +103,8 @@ int main(int argc, char const *argv[])
 		while (true)
 		{
 			std::cout << "> ";
-			std::getline(std::cin, code);
+			if (!std::getline(std::cin, code))
+				break;
 			try
 			{
 				auto comp = wrapper.compileCode(code, std::filesystem::current_path() / "*");
@@ -131,23 +148,17 @@ int main(int argc, char const *argv[])
 	}
 	else
 	{
-		std::ifstream file;
-		file.open(options["file"]);
-		if (!file.is_open())
+		std::string content = "";
+		if (options["standard"] == "true")
+			content = KEYWORD_LOAD " \"standard\";\n";
+		if (!dir::readFile(options["file"], content))
 		{
 			std::cerr << _FAILURE_FILEPATH_ << options["file"] << "\n";
 			return 1;
 		}
 
-		std::string content = "";
-		std::string line;
-		while (std::getline(file, line))
-			content += line + "\n";
-
 		try
 		{
-			if (options["standard"] == "true")
-				content = (KEYWORD_LOAD " \"standard\";\n") + content;
 			auto entry = wrapper.compileCode(content, std::filesystem::path(options["file"]));
 			wrapper.runCode(entry, tree);
 		}
@@ -0,0 +1,68 @@
+#ifndef BYTES_H
+#define BYTES_H
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstring>
+
+// Contiguous byte buffer handed between libraries as a pointer; slices alias the same storage
+struct bytes_t
+{
+    std::shared_ptr<std::vector<unsigned char>> data;
+    size_t offset;
+    size_t length;
+
+    bytes_t(const size_t &length)
+        : data{std::make_shared<std::vector<unsigned char>>(length)}, offset{0}, length{length}
+    {
+    }
+
+    bytes_t(const std::string &s)
+        : data{std::make_shared<std::vector<unsigned char>>(s.begin(), s.end())}, offset{0}, length{s.size()}
+    {
+    }
+
+    bytes_t(const std::shared_ptr<std::vector<unsigned char>> &data, const size_t &offset, const size_t &length)
+        : data{data}, offset{offset}, length{length}
+    {
+    }
+
+    inline unsigned char *begin() const
+    {
+        return data->data() + offset;
+    }
+
+    inline const bytes_t slice(size_t start, size_t count) const
+    {
+        if (start > length)
+            start = length;
+        if (count > length - start)
+            count = length - start;
+        return bytes_t(data, offset + start, count);
+    }
+
+    inline const std::string toString() const
+    {
+        return std::string(reinterpret_cast<const char *>(begin()), length);
+    }
+
+    // Unsigned integer of `width` bytes at `at`; the caller checks bounds
+    inline const unsigned long long readInt(const size_t &at, const size_t &width, const bool &bigEndian) const
+    {
+        unsigned long long v = 0;
+        const unsigned char *p = begin() + at;
+        for (size_t i = 0; i < width; i++)
+            v |= static_cast<unsigned long long>(p[bigEndian ? width - 1 - i : i]) << (8 * i);
+        return v;
+    }
+
+    inline void writeInt(const size_t &at, const size_t &width, unsigned long long v, const bool &bigEndian) const
+    {
+        unsigned char *p = begin() + at;
+        for (size_t i = 0; i < width; i++, v >>= 8)
+            p[bigEndian ? width - 1 - i : i] = static_cast<unsigned char>(v & 0xFF);
+    }
+};
+
+#endif
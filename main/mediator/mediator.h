@@ -1,5 +1,5 @@
 #ifndef MEDIATOR_H
-#define MEDATIOR_H
+#define MEDIATOR_H
 
 #include <variant>
 #include <vector>
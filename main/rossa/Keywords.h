@@ -21,6 +21,7 @@
 #define KEYWORD_FALSE "false"
 #define KEYWORD_FOR "for"
 #define KEYWORD_FUNCTION "Function"
+#define KEYWORD_GC "gc"
 #define KEYWORD_IF "if"
 #define KEYWORD_IN "in"
 #define KEYWORD_INIT "init"
@@ -70,6 +70,7 @@
 #define _INCOMPATIBLE_VECTOR_SIZES_ "Size of " KEYWORD_ARRAY " values are not compatible"
 #define _CANNOT_MAKE_CONST_ "Expression cannot be parsed in a constant manner"
 #define _TOO_MANY_ARGUMENTS_ "Unexpected amount of arguments for function: `{0}`"
+#define _MAX_DEPTH_REACHED_ "Maximum call depth exceeded ({0} frames)"
 #endif
 
 #ifdef _LOCALE_ITA_
@@ -135,6 +136,7 @@
 #define _INCOMPATIBLE_VECTOR_SIZES_ "Taglia dei valori Vettori [" KEYWORD_ARRAY "] non ha compatabilità"
 #define _CANNOT_MAKE_CONST_ "Non si può processare l'espressione con un modo costante"
 #define _TOO_MANY_ARGUMENTS_ "Il numero degli argomenti è inaspettato per la funzione: `{0}`"
+#define _MAX_DEPTH_REACHED_ "Profondità massima delle chiamate superata ({0} cornici)"
 #endif
 
 #ifdef _LOCALE_LAT_
@@ -200,6 +202,7 @@
 #define _INCOMPATIBLE_VECTOR_SIZES_ "Magnitūdinēs valōrum Tabulae [" KEYWORD_ARRAY "] nōn congruunt"
 #define _CANNOT_MAKE_CONST_ "Ēnūntiātiō nōn cōnstante prōcēditur"
 #define _TOO_MANY_ARGUMENTS_ "Numerus argūmentōrum inexspectātus est prō prōcessiōne: `{0}`"
+#define _MAX_DEPTH_REACHED_ "Altitūdō maxima vocātiōnum excessa est ({0} gradūs)"
 #endif
 
 #ifdef _LOCALE_JPN_
@@ -265,6 +268,7 @@
 #define _INCOMPATIBLE_VECTOR_SIZES_ "同意列（" KEYWORD_ARRAY "）の値の大きさは相容れない"
 #define _CANNOT_MAKE_CONST_ "表現は一定の法に解析されない"
 #define _TOO_MANY_ARGUMENTS_ "関数に助変数の数は案外：「{0}」"
+#define _MAX_DEPTH_REACHED_ "呼び出しの深さの上限を超えた（{0}フレーム）"
 #endif
 
 #endif
\ No newline at end of file
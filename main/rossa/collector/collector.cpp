@@ -0,0 +1,328 @@
+#include "collector.h"
+
+#include "../scope/scope.h"
+#include "../value/value.h"
+#include "../symbol/symbol.h"
+#include "../object/object.h"
+#include "../function/function.h"
+#include "../wrapper/wrapper.h"
+#include "../parser/parser.h"
+#include "../stats/stats.h"
+
+#include <unordered_map>
+
+gc_heap_t collector_t::mainHeap;
+thread_local gc_heap_t *collector_t::heap = &collector_t::mainHeap;
+
+std::atomic<refc_ull> collector_t::collections{0};
+std::atomic<refc_ull> collector_t::scopesFreed{0};
+std::atomic<refc_ull> collector_t::valuesFreed{0};
+
+struct gc_node_t
+{
+	refc_ull internal = 0;
+	refc_ull external = 0;
+	bool live = false;
+};
+
+struct gc_graph_t
+{
+	std::unordered_map<scope_t *, gc_node_t> scopes;
+	std::unordered_map<value_t *, gc_node_t> values;
+	std::unordered_map<function_t *, gc_node_t> functions;
+	std::vector<value_t *> valueQueue;
+	std::vector<function_t *> functionQueue;
+};
+
+void collector_t::track(scope_t *scope)
+{
+	gc_heap_t *h = heap;
+	std::lock_guard<std::mutex> guard(h->lock);
+	scope->gcHeap = h;
+	scope->gcPrev = NULL;
+	scope->gcNext = h->head;
+	if (h->head != NULL)
+		h->head->gcPrev = scope;
+	h->head = scope;
+	h->tracked++;
+	h->pressure++;
+}
+
+// A scope may be released on another thread than the one that created it, so it unlinks from the heap it remembers
+void collector_t::untrack(scope_t *scope)
+{
+	gc_heap_t *h = scope->gcHeap;
+	std::lock_guard<std::mutex> guard(h->lock);
+	if (scope->gcPrev != NULL)
+		scope->gcPrev->gcNext = scope->gcNext;
+	else
+		h->head = scope->gcNext;
+	if (scope->gcNext != NULL)
+		scope->gcNext->gcPrev = scope->gcPrev;
+	h->tracked--;
+}
+
+static void gc_visitValue(gc_graph_t &graph, value_t *value, const refc_ull &references)
+{
+	auto r = graph.values.insert({value, gc_node_t()});
+	r.first->second.internal++;
+	if (r.second)
+	{
+		r.first->second.external = references;
+		graph.valueQueue.push_back(value);
+	}
+}
+
+static void gc_visitFunction(gc_graph_t &graph, const ptr_function_t &function)
+{
+	if (function == nullptr)
+		return;
+	auto r = graph.functions.insert({function.get(), gc_node_t()});
+	r.first->second.internal++;
+	if (r.second)
+	{
+		r.first->second.external = function.use_count();
+		graph.functionQueue.push_back(function.get());
+	}
+}
+
+template <class V, class S, class O, class F>
+static void gc_forValue(const V &v, S &&onSymbol, O &&onScope, F &&onFunction)
+{
+	if (auto a = std::get_if<std::vector<symbol_t>>(&v))
+	{
+		for (auto &e : *a)
+			onSymbol(e);
+	}
+	else if (auto d = std::get_if<std::map<const std::string, const symbol_t>>(&v))
+	{
+		for (auto &e : *d)
+			onSymbol(e.second);
+	}
+	else if (auto o = std::get_if<object_t>(&v))
+	{
+		if (o->type == OBJECT_STRONG && o->getPtr() != NULL)
+			onScope(o->getPtr());
+	}
+	else if (auto w = std::get_if<wrapper_t>(&v))
+	{
+		for (auto &e : w->map)
+			for (auto &f : e.second)
+				onFunction(f.second);
+		onFunction(w->varg);
+	}
+}
+
+const std::pair<refc_ull, refc_ull> collector_t::collect()
+{
+	gc_heap_t *h = heap;
+	if (h->running || refcount_t::threaded)
+		return {0, 0};
+	h->running = true;
+
+	gc_graph_t graph;
+	{
+		std::lock_guard<std::mutex> guard(h->lock);
+		graph.scopes.reserve(h->tracked);
+		graph.values.reserve(h->tracked * 4);
+		for (scope_t *s = h->head; s != NULL; s = s->gcNext)
+			graph.scopes[s].external = s->references;
+		h->pressure = 0;
+	}
+
+	// Count every reference held from inside the graph
+	for (auto &s : graph.scopes)
+		for (auto &e : s.first->values)
+			gc_visitValue(graph, e.second.d, e.second.d->references);
+
+	while (!graph.valueQueue.empty() || !graph.functionQueue.empty())
+	{
+		if (!graph.valueQueue.empty())
+		{
+			value_t *v = graph.valueQueue.back();
+			graph.valueQueue.pop_back();
+			gc_forValue(
+				v->value,
+				[&](const symbol_t &s) { gc_visitValue(graph, s.d, s.d->references); },
+				[&](scope_t *s) {
+					auto it = graph.scopes.find(s);
+					if (it != graph.scopes.end())
+						it->second.internal++;
+				},
+				[&](const ptr_function_t &f) { gc_visitFunction(graph, f); });
+		}
+		else
+		{
+			function_t *f = graph.functionQueue.back();
+			graph.functionQueue.pop_back();
+			auto it = graph.scopes.find(f->captures.getPtr());
+			if (it != graph.scopes.end())
+				it->second.internal++;
+		}
+	}
+
+	// Anything referenced from outside the graph is a root; mark from there
+	std::vector<scope_t *> scopeQueue;
+	std::vector<value_t *> valueQueue;
+	std::vector<function_t *> functionQueue;
+
+	auto markScope = [&](scope_t *s) {
+		auto it = graph.scopes.find(s);
+		if (it != graph.scopes.end() && !it->second.live)
+		{
+			it->second.live = true;
+			scopeQueue.push_back(s);
+		}
+	};
+	auto markValue = [&](value_t *v) {
+		auto it = graph.values.find(v);
+		if (it != graph.values.end() && !it->second.live)
+		{
+			it->second.live = true;
+			valueQueue.push_back(v);
+		}
+	};
+	auto markFunction = [&](function_t *f) {
+		auto it = graph.functions.find(f);
+		if (it != graph.functions.end() && !it->second.live)
+		{
+			it->second.live = true;
+			functionQueue.push_back(f);
+		}
+	};
+
+	for (auto &s : graph.scopes)
+		if (s.second.external > s.second.internal)
+			markScope(s.first);
+	for (auto &v : graph.values)
+		if (v.second.external > v.second.internal)
+			markValue(v.first);
+	for (auto &f : graph.functions)
+		if (f.second.external > f.second.internal)
+			markFunction(f.first);
+
+	while (!scopeQueue.empty() || !valueQueue.empty() || !functionQueue.empty())
+	{
+		if (!scopeQueue.empty())
+		{
+			scope_t *s = scopeQueue.back();
+			scopeQueue.pop_back();
+			// Parent pointers are not counted, but a live scope still needs its parents
+			markScope(s->parent);
+			for (auto &e : s->values)
+				markValue(e.second.d);
+		}
+		else if (!valueQueue.empty())
+		{
+			value_t *v = valueQueue.back();
+			valueQueue.pop_back();
+			gc_forValue(
+				v->value,
+				[&](const symbol_t &s) { markValue(s.d); },
+				markScope,
+				[&](const ptr_function_t &f) { markFunction(f.get()); });
+		}
+		else
+		{
+			function_t *f = functionQueue.back();
+			functionQueue.pop_back();
+			markScope(f->parent);
+			markScope(f->captures.getPtr());
+		}
+	}
+
+	std::vector<scope_t *> deadScopes;
+	std::vector<value_t *> deadValues;
+	for (auto &s : graph.scopes)
+	{
+		if (!s.second.live)
+		{
+			s.first->references++;
+			deadScopes.push_back(s.first);
+		}
+	}
+	for (auto &v : graph.values)
+	{
+		if (!v.second.live)
+		{
+			v.first->references++;
+			deadValues.push_back(v.first);
+		}
+	}
+
+	// Run deleters while the cycle is still intact
+	for (auto &s : deadScopes)
+	{
+		if (s->type != scope_type_enum::SCOPE_INSTANCE)
+			continue;
+		const auto it = s->values.find(parser_t::HASH_DELETER);
+		if (it != s->values.end())
+		{
+			trace_t stack_trace;
+			try
+			{
+				it->second.call({}, NULL, stack_trace);
+			}
+			catch (const rossa_error_t &e)
+			{
+				parser_t::printError(e);
+			}
+		}
+	}
+
+	// Break the cycles, mirroring what ~scope_t would do
+	for (auto &s : deadScopes)
+	{
+		for (auto &e : s->values)
+			e.second.shift(s);
+		std::map<const hash_ull, const symbol_t> temp;
+		temp.swap(s->values);
+	}
+	for (auto &v : deadValues)
+	{
+		v->value = std::monostate();
+		v->type = NIL;
+	}
+
+	refc_ull freedValues = 0;
+	refc_ull freedScopes = 0;
+	for (auto &v : deadValues)
+	{
+		if (--v->references == 0)
+		{
+			stats::countValueFree();
+			delete v;
+			freedValues++;
+		}
+	}
+	for (auto &s : deadScopes)
+	{
+		if (--s->references == 0)
+		{
+			delete s;
+			freedScopes++;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(h->lock);
+		h->threshold = std::max<refc_ull>(COLLECTOR_MIN_THRESHOLD, h->tracked * 2);
+	}
+	collections++;
+	scopesFreed += freedScopes;
+	valuesFreed += freedValues;
+	h->running = false;
+	return {freedScopes, freedValues};
+}
+
+const symbol_t collector_t::getStats(const std::pair<refc_ull, refc_ull> &last)
+{
+	std::map<const std::string, const symbol_t> ret;
+	ret.insert({"scopes", symbol_t::Number(number_t::Long(last.first))});
+	ret.insert({"values", symbol_t::Number(number_t::Long(last.second))});
+	ret.insert({"collections", symbol_t::Number(number_t::Long(collections))});
+	ret.insert({"scopesFreed", symbol_t::Number(number_t::Long(scopesFreed))});
+	ret.insert({"valuesFreed", symbol_t::Number(number_t::Long(valuesFreed))});
+	ret.insert({"tracked", symbol_t::Number(number_t::Long(heap->tracked))});
+	return symbol_t::Dictionary(ret);
+}
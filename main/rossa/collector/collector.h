@@ -0,0 +1,64 @@
+#ifndef COLLECTOR_H
+#define COLLECTOR_H
+
+#include "../rossa.h"
+
+#include <mutex>
+
+/**
+ * Backup cycle collector
+ * Reference counting frees everything except cycles (an instance storing
+ * itself, a closure capturing its own object, ...). Every live `scope_t`
+ * is tracked; a collection subtracts the references held between scopes,
+ * values and functions, keeps whatever is still referenced from outside
+ * that graph, and breaks the remaining cycles.
+ *
+ * Scopes are tracked per heap. The main interpreter and every isolate own a
+ * heap, and a collection only walks the heap of the calling thread.
+ *
+ * A collection walks every scope of its heap, so it only runs while a single
+ * thread can be evaluating that heap's Rossa code; once `refcount_t::threaded`
+ * is set on the calling thread, cycles are left to leak rather than be torn
+ * down under another thread. Pool and thread tasks track their scopes in the
+ * heap of the interpreter that started them, so one interpreter going
+ * threaded leaves the collector of every other one running.
+ */
+#define COLLECTOR_MIN_THRESHOLD 65536
+
+struct gc_heap_t
+{
+	scope_t *head = NULL;
+	std::mutex lock;
+	// Written under `lock`, but polled without it on every call
+	std::atomic<refc_ull> tracked{0};
+	std::atomic<refc_ull> pressure{0};
+	std::atomic<refc_ull> threshold{COLLECTOR_MIN_THRESHOLD};
+	bool running = false;
+};
+
+class collector_t
+{
+private:
+	static gc_heap_t mainHeap;
+
+public:
+	// Heap new scopes on this thread are tracked in; only an isolate's thread points anywhere but the main heap
+	static thread_local gc_heap_t *heap;
+
+	static std::atomic<refc_ull> collections;
+	static std::atomic<refc_ull> scopesFreed;
+	static std::atomic<refc_ull> valuesFreed;
+
+	static void track(scope_t *);
+	static void untrack(scope_t *);
+	static const std::pair<refc_ull, refc_ull> collect();
+	static const symbol_t getStats(const std::pair<refc_ull, refc_ull> &);
+
+	inline static void poll()
+	{
+		if (!refcount_t::threaded && heap->pressure.load(std::memory_order_relaxed) >= heap->threshold.load(std::memory_order_relaxed))
+			collect();
+	}
+};
+
+#endif
@@ -4,83 +4,149 @@
 #include "../instruction/instruction.h"
 #include "../scope/scope.h"
 #include "../parser/parser.h"
+#include "../stats/stats.h"
+#include "../collector/collector.h"
+#include "../util/util.h"
 
-function_t::function_t(const hash_ull &key, scope_t *parent, const std::vector<std::pair<bool, hash_ull>> &params, const ptr_instruction_t &body, const std::map<const hash_ull, const symbol_t> &captures)
-	: key{key}, parent{parent}, params{params}, body{body}, captures{captures}, isVargs{false}
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#define NATIVE_STACK_RESERVE (256 * 1024)
+
+function_t::function_t(const hash_ull &key, scope_t *parent, const std::vector<std::pair<bool, hash_ull>> &params, const ptr_instruction_t &body, const object_t &captures, const std::shared_ptr<const std::vector<field_store_t>> &stores)
+	: key{key}, parent{parent}, params{params}, body{body}, captures{captures}, isVargs{false}, stores{stores}
 {
 }
 
-function_t::function_t(const hash_ull &key, scope_t *parent, const ptr_instruction_t &body, const std::map<const hash_ull, const symbol_t> &captures)
+function_t::function_t(const hash_ull &key, scope_t *parent, const ptr_instruction_t &body, const object_t &captures)
 	: key{key}, parent{parent}, body{body}, captures{captures}, isVargs{true}
 {
 }
 
-const symbol_t function_evaluate(const ptr_function_t &function, const std::vector<symbol_t> &paramValues, const token_t *token, trace_t &stack_trace)
+// A scalar that nothing else refers to is already a private copy, so returning it as-is matches set()
+inline static bool isScalar(const symbol_t &s)
 {
-	stack_trace.push_back({(token == NULL ? token_t() : *token), *function.get()});
-	if (function->isVargs)
-		return function_evaluate_vargs(function, paramValues, token, stack_trace);
+	switch (s.getValueType())
+	{
+	case value_type_enum::NIL:
+	case value_type_enum::NUMBER:
+	case value_type_enum::BOOLEAN_D:
+	case value_type_enum::STRING:
+		return true;
+	default:
+		return false;
+	}
+}
 
-	object_t p(function->parent, object_type_enum::OBJECT_WEAK);
-	const object_t newScope(&p, 0);
+thread_local tail_call_t *tailCallSlot = NULL;
 
-	for (size_t i = 0; i < function->params.size(); i++)
+tail_guard_t::tail_guard_t(tail_call_t *slot)
+	: outer{tailCallSlot}
+{
+	tailCallSlot = slot;
+}
+
+tail_guard_t::~tail_guard_t()
+{
+	tailCallSlot = outer;
+}
+
+#ifndef _WIN32
+// Lowest address this thread may recurse down to, leaving room for the native frames below a call
+static const char *nativeStackLimit()
+{
+	thread_local const char *limit = NULL;
+	if (limit == NULL)
 	{
-		if (function->params[i].first) {
-			newScope.createVariable(function->params[i].second, paramValues[i], token);
-		} else {
-			const symbol_t &temp = newScope.createVariable(function->params[i].second, token);
-			temp.set(&paramValues[i], token, stack_trace);
+		pthread_attr_t attr;
+		void *addr = NULL;
+		size_t size = 0;
+		if (pthread_getattr_np(pthread_self(), &attr) == 0)
+		{
+			pthread_attr_getstack(&attr, &addr, &size);
+			pthread_attr_destroy(&attr);
 		}
+		limit = reinterpret_cast<const char *>(addr) + (size > NATIVE_STACK_RESERVE * 2 ? NATIVE_STACK_RESERVE : size / 2);
 	}
+	return limit;
+}
+#endif
 
-	for (const std::pair<const hash_ull, const symbol_t> &e : function->captures)
+inline static void checkDepth(const token_t *token, trace_t &stack_trace)
+{
+	bool exceeded = parser_t::maxDepth > 0 && stack_trace.size() >= parser_t::maxDepth;
+#ifndef _WIN32
+	const char marker = 0;
+	exceeded = exceeded || &marker < nativeStackLimit();
+#endif
+	if (exceeded)
+		throw rossa_error_t(util::format(_MAX_DEPTH_REACHED_, {std::to_string(stack_trace.size())}), (token == NULL ? token_t() : *token), stack_trace);
+}
+
+// One activation of `function`; a tail call made from its body is left in `tail` instead of being run here
+static const symbol_t function_frame(const ptr_function_t &function, const std::vector<symbol_t> &paramValues, const token_t *token, trace_t &stack_trace, tail_call_t &tail)
+{
+	object_t p(function->captures.getPtr() != NULL ? function->captures.getPtr() : function->parent, object_type_enum::OBJECT_WEAK);
+	const object_t newScope(&p, 0);
+
+	if (function->isVargs)
 	{
-		newScope.createVariable(e.first, e.second, token);
+		newScope.createVariable(parser_t::HASH_VAR_ARGS, symbol_t::Array(paramValues), token);
+	}
+	else
+	{
+		for (size_t i = 0; i < function->params.size(); i++)
+		{
+			if (function->params[i].first) {
+				newScope.createVariable(function->params[i].second, paramValues[i], token);
+			} else {
+				const symbol_t &temp = newScope.createVariable(function->params[i].second, token);
+				temp.set(&paramValues[i], token, stack_trace);
+			}
+		}
 	}
 
+	tail.frame = newScope.getPtr();
 	symbol_t temp = function->body->evaluate(&newScope, stack_trace);
 
-	if (temp.getSymbolType() == symbol_t::type_t::ID_REFER)
+	if (temp.getSymbolType() == symbol_t::type_t::ID_REFER || (temp.isUnique() && isScalar(temp)))
 	{
 		temp.setSymbolType(symbol_t::type_t::ID_CASUAL);
-
-		stack_trace.pop_back();
 		return temp;
 	}
 
 	const symbol_t ret = symbol_t();
 	ret.set(&temp, token, stack_trace);
-
-	stack_trace.pop_back();
 	return ret;
 }
 
-const symbol_t function_evaluate_vargs(const ptr_function_t &function, const std::vector<symbol_t> &paramValues, const token_t *token, trace_t &stack_trace)
+const symbol_t function_evaluate(const ptr_function_t &function, const std::vector<symbol_t> &paramValues, const token_t *token, trace_t &stack_trace)
 {
-	object_t p(function->parent, object_type_enum::OBJECT_WEAK);
-	const object_t newScope(&p, 0);
+	checkDepth(token, stack_trace);
+	stats::countCall(function->key);
+	collector_t::poll();
+	stack_trace.push_back({(token == NULL ? token_t() : *token), function});
 
-	newScope.createVariable(parser_t::HASH_VAR_ARGS, symbol_t::Array(paramValues), token);
+	tail_call_t tail;
+	const tail_guard_t guard(&tail);
+	symbol_t ret = function_frame(function, paramValues, token, stack_trace, tail);
 
-	for (const std::pair<const hash_ull, const symbol_t> &e : function->captures)
+	// Tail calls reuse this native frame and its trace entry, so they never deepen either stack
+	while (tail.function != nullptr)
 	{
-		newScope.createVariable(e.first, e.second, token);
+		const ptr_function_t next = std::move(tail.function);
+		const std::vector<symbol_t> params = std::move(tail.params);
+		const token_t callToken = tail.token;
+		tail.function = nullptr;
+		tail.params.clear();
+
+		stats::countCall(next->key);
+		collector_t::poll();
+		stack_trace.back() = {callToken, next};
+		ret = function_frame(next, params, &callToken, stack_trace, tail);
 	}
 
-	symbol_t temp = function->body->evaluate(&newScope, stack_trace);
-
-	if (temp.getSymbolType() == symbol_t::type_t::ID_REFER)
-	{
-		temp.setSymbolType(symbol_t::type_t::ID_CASUAL);
-
-		stack_trace.pop_back();
-		return temp;
-	}
-
-	const symbol_t ret = symbol_t();
-	ret.set(&temp, token, stack_trace);
-
 	stack_trace.pop_back();
 	return ret;
 }
@@ -90,8 +156,65 @@ const object_t function_t::getParent() const
 	return object_t(parent, object_type_enum::OBJECT_STRONG);
 }
 
-void function_t::shift()
+// Strong references to every scope a call resolves names through, for holders that may outlive the block the function was made in
+const std::vector<object_t> function_t::getScopes() const
+{
+	std::vector<object_t> scopes;
+	getScopes(scopes);
+	return scopes;
+}
+
+// Captured functions count too, since wrappers such as Pool.submit only call through to the closure they captured
+void function_t::getScopes(std::vector<object_t> &scopes) const
 {
-	if (parent != NULL)
+	for (scope_t *s = captures.getPtr() != NULL ? captures.getPtr() : parent; s != NULL; s = s->getParent())
+		scopes.push_back(object_t(s, object_type_enum::OBJECT_STRONG));
+	if (captures.getPtr() == NULL)
+		return;
+
+	std::vector<symbol_t> captured;
+	{
+		spin_guard_t guard(captures.getPtr()->valuesLock);
+		for (auto &e : captures.getPtr()->values)
+		{
+			if (e.second.getValueType() == value_type_enum::FUNCTION)
+				captured.push_back(e.second);
+		}
+	}
+	trace_t stack_trace;
+	for (auto &c : captured)
+	{
+		for (auto &e : c.getFunctionOverloads(NULL, stack_trace))
+		{
+			for (auto &f : e.second)
+				f.second->getScopes(scopes);
+		}
+		if (c.hasVarg(NULL, stack_trace))
+			c.getVARGFunction(NULL, stack_trace)->getScopes(scopes);
+	}
+}
+
+// Whether the lexical parents of this function stay alive once the frame `scope` has been left;
+// the chain above `held` is already known to, since whoever asks keeps that scope alive
+const bool function_t::outlives(const scope_t *scope, const scope_t *held) const
+{
+	for (const scope_t *s = parent; s != NULL; s = s->getParent())
+	{
+		if (s == held)
+			return true;
+		if (s == scope || s->getType() == scope_type_enum::SCOPE_INSTANCE)
+			return false;
+	}
+	return true;
+}
+
+// Only functions declared in the dying scope move up; values merely passed through it keep their parent
+void function_t::shift(const scope_t *scope)
+{
+	if (parent != NULL && parent == scope)
+	{
 		parent = parent->getParent();
+		if (captures.getPtr() != NULL)
+			captures.getPtr()->parent = parent;
+	}
 }
\ No newline at end of file
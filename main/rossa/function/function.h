@@ -3,6 +3,16 @@
 
 #include "../rossa.h"
 #include "../rossa_error/rossa_error.h"
+#include "../object/object.h"
+
+// One `this.<field> = <argument or constant>` of an `init` that DefineI compiled to a direct store
+struct field_store_t
+{
+	hash_ull field;
+	size_t param;
+	// Stored instead of the argument when set
+	ptr_instruction_t constant;
+};
 
 struct function_t : public std::enable_shared_from_this<function_t>
 {
@@ -10,16 +20,43 @@ struct function_t : public std::enable_shared_from_this<function_t>
 	scope_t *parent;
 	const std::vector<std::pair<bool, hash_ull>> params;
 	const ptr_instruction_t body;
-	const std::map<const hash_ull, const symbol_t> captures;
+	// Captured values live in one scope between `parent` and every frame, shared by all calls (NULL without captures)
+	const object_t captures;
 	const bool isVargs;
+	// Set when the whole body is field stores, so `new` can run them without a frame
+	const std::shared_ptr<const std::vector<field_store_t>> stores;
 
-	function_t(const hash_ull &, scope_t *, const std::vector<std::pair<bool, hash_ull>> &, const ptr_instruction_t &, const std::map<const hash_ull, const symbol_t> &);
-	function_t(const hash_ull &, scope_t *, const ptr_instruction_t &, const std::map<const hash_ull, const symbol_t> &);
+	function_t(const hash_ull &, scope_t *, const std::vector<std::pair<bool, hash_ull>> &, const ptr_instruction_t &, const object_t &, const std::shared_ptr<const std::vector<field_store_t>> & = nullptr);
+	function_t(const hash_ull &, scope_t *, const ptr_instruction_t &, const object_t &);
 	const object_t getParent() const;
-	void shift();
+	const std::vector<object_t> getScopes() const;
+	void getScopes(std::vector<object_t> &) const;
+	const bool outlives(const scope_t *, const scope_t * = NULL) const;
+	void shift(const scope_t *);
+};
+
+// A `return f(...)` in tail position is handed back to the enclosing frame through this instead of recursing
+struct tail_call_t
+{
+	scope_t *frame = NULL;
+	ptr_function_t function = nullptr;
+	std::vector<symbol_t> params;
+	token_t token;
+};
+
+// Pending tail call slot of the innermost frame, NULL where a tail call must not leave the current frame
+extern thread_local tail_call_t *tailCallSlot;
+
+// Installs a tail call slot (NULL forbids tail calls) for the lifetime of the guard
+class tail_guard_t
+{
+	tail_call_t *const outer;
+
+public:
+	tail_guard_t(tail_call_t *);
+	~tail_guard_t();
 };
 
 const symbol_t function_evaluate(const ptr_function_t &, const std::vector<symbol_t> &, const token_t *, trace_t &);
-const symbol_t function_evaluate_vargs(const ptr_function_t &, const std::vector<symbol_t> &, const token_t *, trace_t &);
 
 #endif
\ No newline at end of file
@@ -8,23 +8,210 @@
 
 #include "../util/util.h"
 
-std::vector<std::filesystem::path> dir::loaded = {};
+#include <fstream>
+#include <deque>
+#include <functional>
+#include <condition_variable>
+
+thread_local dir::load_set_t dir::loads;
 std::map<std::string, std::map<std::string, extf_t>> global::loaded = {};
+std::mutex global::loadedLock;
 
-const std::filesystem::path dir::findFile(const std::filesystem::path &currentDir, const std::string &filename, const token_t *token)
+const std::filesystem::path dir::tryFindFile(const std::filesystem::path &currentDir, const std::string &filename)
+{
+	return tryFindFile(&loads, currentDir, filename);
+}
+
+// Prefetch workers search on behalf of the set they were started for
+const std::filesystem::path dir::tryFindFile(load_set_t *set, const std::filesystem::path &currentDir, const std::string &filename)
 {
 	auto currentDirCheck = currentDir / filename;
 	if (std::filesystem::exists(currentDirCheck))
 		return currentDirCheck;
-	auto libDirCheck = util::getRuntimePath().parent_path() / "lib" / filename;
+	std::filesystem::path libDir;
+	{
+		std::lock_guard<std::mutex> guard(set->lock);
+		libDir = set->libraryPath;
+	}
+	if (libDir.empty())
+		libDir = util::getRuntimePath().parent_path() / "lib";
+	auto libDirCheck = libDir / filename;
 	if (std::filesystem::exists(libDirCheck))
 		return libDirCheck;
+	return std::filesystem::path();
+}
+
+const std::filesystem::path dir::findFile(const std::filesystem::path &currentDir, const std::string &filename, const token_t *token)
+{
+	auto path = tryFindFile(currentDir, filename);
+	if (!path.empty())
+		return path;
 	trace_t stack_trace;
 	throw rossa_error_t(util::format(_FILE_NOT_FOUND_, {filename}), *token, stack_trace);
 }
 
+// Append the whole file to content with a single read, keeping the trailing newline the lexer expects
+const bool dir::readFile(const std::filesystem::path &path, std::string &content)
+{
+	std::ifstream myfile(path, std::ios::in | std::ios::binary);
+	if (!myfile.is_open())
+		return false;
+
+	myfile.seekg(0, std::ios::end);
+	const auto size = myfile.tellg();
+	myfile.seekg(0, std::ios::beg);
+	if (size > 0)
+	{
+		const size_t offset = content.size();
+		content.resize(offset + static_cast<size_t>(size));
+		myfile.read(&content[offset], size);
+		content.resize(offset + static_cast<size_t>(myfile.gcount()));
+	}
+	if (content.empty() || content.back() != '\n')
+		content.push_back('\n');
+	return true;
+}
+
+const std::vector<token_t> dir::lexFile(const std::filesystem::path &path)
+{
+	std::string content;
+	readFile(path, content);
+	return lexString(std::move(content), path.filename().string());
+}
+
+// A handful of threads lexing files ahead of the parser; started on first use and joined at exit
+class prefetch_pool_t
+{
+private:
+	std::mutex lock;
+	std::condition_variable ready;
+	std::deque<std::function<void()>> jobs;
+	std::vector<std::thread> workers;
+	size_t idle = 0;
+	bool stopping = false;
+
+	void run()
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		while (true)
+		{
+			idle++;
+			ready.wait(guard, [this]() { return stopping || !jobs.empty(); });
+			idle--;
+			if (jobs.empty())
+				return;
+			auto job = std::move(jobs.front());
+			jobs.pop_front();
+			guard.unlock();
+			job();
+			guard.lock();
+		}
+	}
+
+public:
+	static prefetch_pool_t &get()
+	{
+		static prefetch_pool_t pool;
+		return pool;
+	}
+
+	void submit(std::function<void()> &&job)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		jobs.push_back(std::move(job));
+		if (idle == 0 && workers.size() < std::max(1u, std::min(4u, std::thread::hardware_concurrency())))
+			workers.emplace_back(&prefetch_pool_t::run, this);
+		ready.notify_one();
+	}
+
+	~prefetch_pool_t()
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stopping = true;
+		}
+		ready.notify_all();
+		for (auto &w : workers)
+			w.join();
+	}
+};
+
+dir::load_set_t::~load_set_t()
+{
+	// A running prefetch may queue more files into this set, so keep waiting until none are left
+	while (true)
+	{
+		std::map<std::filesystem::path, std::shared_future<std::vector<token_t>>> left;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			left.swap(pending);
+		}
+		if (left.empty())
+			return;
+		for (auto &e : left)
+			e.second.wait();
+	}
+}
+
+// Whether `path` still has to be loaded, marking it as loaded
+const bool dir::markLoaded(const std::filesystem::path &path)
+{
+	std::lock_guard<std::mutex> guard(loads.lock);
+	return loads.loaded.insert(path).second;
+}
+
+const std::vector<token_t> dir::getTokens(const std::filesystem::path &path)
+{
+	std::shared_future<std::vector<token_t>> f;
+	{
+		std::lock_guard<std::mutex> guard(loads.lock);
+		auto it = loads.pending.find(path);
+		if (it == loads.pending.end())
+			return lexFile(path);
+		f = it->second;
+		loads.pending.erase(it);
+	}
+	return f.get();
+}
+
+void dir::prefetch(const std::vector<token_t> &tokens, const std::filesystem::path &currentDir)
+{
+	prefetch(&loads, tokens, currentDir);
+}
+
+// Scan a lexed file for `load "..."` statements and start lexing every dependency
+// that has not been seen yet. Parsing still happens in source order on the calling
+// thread, so this only moves file reads and lexing off the critical path.
+void dir::prefetch(load_set_t *set, const std::vector<token_t> &tokens, const std::filesystem::path &currentDir)
+{
+	for (size_t i = 0; i + 1 < tokens.size(); i++)
+	{
+		if (tokens[i].type != TOK_LOAD || tokens[i + 1].type != TOK_STR_LIT)
+			continue;
+
+		auto path = tryFindFile(set, currentDir, tokens[i + 1].valueString + ".ra");
+		if (path.empty())
+			continue;
+
+		std::shared_ptr<std::packaged_task<std::vector<token_t>()>> task;
+		{
+			std::lock_guard<std::mutex> guard(set->lock);
+			if (set->pending.find(path) != set->pending.end() || set->loaded.find(path) != set->loaded.end())
+				continue;
+			task = std::make_shared<std::packaged_task<std::vector<token_t>()>>([set, path]() {
+				auto tokens = lexFile(path);
+				prefetch(set, tokens, path.parent_path());
+				return tokens;
+			});
+			set->pending[path] = task->get_future().share();
+		}
+		prefetch_pool_t::get().submit([task]() { (*task)(); });
+	}
+}
+
 void global::loadLibrary(const std::filesystem::path &currentDir, const std::string &rawlibname, const token_t *token)
 {
+	std::lock_guard<std::mutex> guard(loadedLock);
 	if (loaded.find(rawlibname) == loaded.end())
 	{
 #ifndef _WIN32
@@ -61,6 +248,7 @@ void global::loadLibrary(const std::filesystem::path &currentDir, const std::str
 
 extf_t global::loadFunction(const std::string &rawlibname, const std::string &fname, const token_t *token)
 {
+	std::lock_guard<std::mutex> guard(loadedLock);
 	if (loaded.find(rawlibname) == loaded.end())
 	{
 		trace_t stack_trace;
@@ -6,16 +6,43 @@
 
 #include "../../mediator/mediator.h"
 
+#include <future>
+#include <mutex>
+#include <set>
+
 namespace dir
 {
-	extern std::vector<std::filesystem::path> loaded;
-
+	// Files an interpreter has loaded, and the ones being lexed ahead for it; shared with the prefetch workers
+	struct load_set_t
+	{
+		std::mutex lock;
+		std::set<std::filesystem::path> loaded;
+		std::map<std::filesystem::path, std::shared_future<std::vector<token_t>>> pending;
+		// Searched after the loading file's own directory; empty means the lib directory next to the executable
+		std::filesystem::path libraryPath;
+
+		// Waits out every prefetch still running for this set
+		~load_set_t();
+	};
+
+	// Load set of the interpreter on this thread; every isolate has its own
+	extern thread_local load_set_t loads;
+
+	const std::filesystem::path tryFindFile(const std::filesystem::path &, const std::string &);
+	const std::filesystem::path tryFindFile(load_set_t *, const std::filesystem::path &, const std::string &);
 	const std::filesystem::path findFile(const std::filesystem::path &, const std::string &, const token_t *token);
+	const bool readFile(const std::filesystem::path &, std::string &);
+	const std::vector<token_t> lexFile(const std::filesystem::path &);
+	const bool markLoaded(const std::filesystem::path &);
+	const std::vector<token_t> getTokens(const std::filesystem::path &);
+	void prefetch(const std::vector<token_t> &, const std::filesystem::path &);
+	void prefetch(load_set_t *, const std::vector<token_t> &, const std::filesystem::path &);
 }
 
 namespace global
 {
 	extern std::map<std::string, std::map<std::string, extf_t>> loaded;
+	extern std::mutex loadedLock;
 
 	void loadLibrary(const std::filesystem::path &, const std::string &, const token_t *token);
 	extf_t loadFunction(const std::string &, const std::string &, const token_t *);
@@ -0,0 +1,70 @@
+#include "host.h"
+
+#include "../global/global.h"
+#include "../node_parser/node_parser.h"
+#include "../util/util.h"
+
+program_t::program_t(const ptr_instruction_t &entry)
+	: entry{entry}
+{
+}
+
+hook_t::hook_t(const symbol_t &function, const token_t &token)
+	: function{function}, token{token}
+{
+}
+
+const mediator_t hook_t::call(const std::vector<mediator_t> &args) const
+{
+	std::vector<symbol_t> params;
+	params.reserve(args.size());
+	for (auto &a : args)
+		params.push_back(global::convertToSymbol(a));
+
+	trace_t stack_trace;
+	return global::convertToMediator(function.call(params, &token, stack_trace), &token, stack_trace);
+}
+
+host_t::host_t(const std::vector<std::string> &args, const bool &standard, const std::filesystem::path &libraryPath)
+	: parser{args}
+{
+	if (!libraryPath.empty())
+	{
+		std::lock_guard<std::mutex> guard(dir::loads.lock);
+		dir::loads.libraryPath = libraryPath;
+	}
+	if (standard)
+		parser.runCode(parser.compileCode(KEYWORD_LOAD " \"standard\";", std::filesystem::current_path() / "*"), false);
+}
+
+const std::shared_ptr<const program_t> host_t::compile(const std::string &code, const std::filesystem::path &file)
+{
+	return std::shared_ptr<const program_t>(new program_t(node_parser_t::genParser(parser.compileCode(code, file))));
+}
+
+const std::shared_ptr<const program_t> host_t::compileFile(const std::filesystem::path &file)
+{
+	std::string content;
+	if (!dir::readFile(file, content))
+	{
+		trace_t stack_trace;
+		throw rossa_error_t(_FAILURE_FILEPATH_ + file.string(), token_t(), stack_trace);
+	}
+	return compile(content, file);
+}
+
+void host_t::run(const program_t &program)
+{
+	parser.runCode(program.entry);
+}
+
+const hook_t host_t::getHook(const std::string &name) const
+{
+	token_t token;
+	token.valueString = name;
+	trace_t stack_trace;
+	const symbol_t &function = parser.main.getVariable(ROSSA_HASH(name), &token, stack_trace);
+	if (function.getValueType() != value_type_enum::FUNCTION)
+		throw rossa_error_t(_NOT_FUNCTION_, token, stack_trace);
+	return hook_t(function, token);
+}
@@ -0,0 +1,63 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include "../rossa.h"
+#include "../parser/parser.h"
+#include "../symbol/symbol.h"
+#include "../../mediator/mediator.h"
+
+/**
+ * Embedding API
+ * A host_t is one interpreter: a global scope and the modules it has loaded.
+ * Code is compiled once into a program_t, which keeps its instruction tree
+ * and can be run any number of times, and a top level function is looked
+ * up once into a hook_t, which calls straight into the function with native
+ * (mediator_t) arguments; nothing is reparsed or regenerated in between.
+ *
+ * A host is not thread-safe, so give every thread its own. Errors are thrown
+ * as rossa_error_t. Modules and libraries are searched for in the loading
+ * file's directory, then in the library path given to the host, which
+ * defaults to the lib directory next to the executable; like the set of
+ * loaded files, it is shared by every host on the same thread. Executables embedding Rossa should be linked with
+ * -rdynamic, as bin/rossa is, so that libraries such as lib_Thread resolve
+ * the interpreter's symbols against them.
+ */
+class program_t
+{
+	friend class host_t;
+
+private:
+	const ptr_instruction_t entry;
+
+	program_t(const ptr_instruction_t &);
+};
+
+// Valid for as long as the host it came from
+class hook_t
+{
+	friend class host_t;
+
+private:
+	const symbol_t function;
+	const token_t token;
+
+	hook_t(const symbol_t &, const token_t &);
+
+public:
+	const mediator_t call(const std::vector<mediator_t> &) const;
+};
+
+class host_t
+{
+private:
+	parser_t parser;
+
+public:
+	host_t(const std::vector<std::string> &, const bool &, const std::filesystem::path & = std::filesystem::path());
+	const std::shared_ptr<const program_t> compile(const std::string &, const std::filesystem::path &);
+	const std::shared_ptr<const program_t> compileFile(const std::filesystem::path &);
+	void run(const program_t &);
+	const hook_t getHook(const std::string &) const;
+};
+
+#endif
@@ -5,7 +5,13 @@
 #include "../node/node.h"
 #include "../node_parser/node_parser.h"
 #include "../parser/parser.h"
+#include "../function/function.h"
 #include "../util/util.h"
+#include "../stats/stats.h"
+#include "../collector/collector.h"
+
+// Values a tail call may inspect among its arguments before it gives up and makes an ordinary call
+#define TAIL_CALL_SCAN 256
 
 /*-------------------------------------------------------------------------------------------------------*/
 /*class Instruction                                                                                      */
@@ -78,26 +84,102 @@ ContainerI::ContainerI(const symbol_t &d, const token_t &token)
 
 const symbol_t ContainerI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return d;
 }
 
+// Copies the captured variables once into the scope all calls of the new closure share
+static const object_t captureScope(const object_t *scope, const std::vector<hash_ull> &captures, const token_t *token, trace_t &stack_trace)
+{
+	if (captures.empty())
+		return object_t();
+
+	const object_t cells(scope, 0);
+	for (const hash_ull &e : captures)
+	{
+		cells.createVariable(e, token).set(&scope->getVariable(e, token, stack_trace), token, stack_trace);
+	}
+	return cells;
+}
+
 /*-------------------------------------------------------------------------------------------------------*/
 /*class DefineI                                                                                      */
 /*-------------------------------------------------------------------------------------------------------*/
 
+// Compiles an `init` whose statements all store an argument or constant into a distinct field, as `this.x = x` or `x = 0`; NULL for anything else
+static const std::shared_ptr<const std::vector<field_store_t>> compileFieldStores(const std::vector<std::pair<bool, hash_ull>> &params, const ptr_instruction_t &body, const std::vector<hash_ull> &captures)
+{
+	if (!captures.empty())
+		return nullptr;
+
+	std::vector<ptr_instruction_t> statements;
+	if (body->getType() == SCOPE_I)
+		statements = static_cast<const ScopeI *>(body.get())->getChildren();
+	else if (body->getType() != CONTAINER)
+		return nullptr;
+
+	const auto paramIndex = [&params](const hash_ull &key) {
+		size_t i = 0;
+		while (i < params.size() && params[i].second != key)
+			i++;
+		return i;
+	};
+
+	std::vector<field_store_t> stores;
+	for (auto &e : statements)
+	{
+		if (e->getType() != SET)
+			return nullptr;
+		const ptr_instruction_t target = static_cast<const SetI *>(e.get())->getA();
+		const ptr_instruction_t source = static_cast<const SetI *>(e.get())->getB();
+
+		hash_ull field;
+		if (target->getType() == INNER)
+		{
+			const InnerI *inner = static_cast<const InnerI *>(target.get());
+			if (inner->getA()->getType() != GET_THIS_I || inner->getB()->getType() != VARIABLE)
+				return nullptr;
+			field = static_cast<const VariableI *>(inner->getB().get())->getKey();
+		}
+		else if (target->getType() == VARIABLE)
+		{
+			field = static_cast<const VariableI *>(target.get())->getKey();
+			// A bare name that is also a parameter assigns the argument, not the field
+			if (paramIndex(field) < params.size())
+				return nullptr;
+		}
+		else
+			return nullptr;
+
+		// A second store would go through whatever the first one left there
+		for (auto &s : stores)
+			if (s.field == field)
+				return nullptr;
+
+		if (source->getType() == VARIABLE)
+		{
+			const size_t i = paramIndex(static_cast<const VariableI *>(source.get())->getKey());
+			if (i == params.size())
+				return nullptr;
+			stores.push_back({field, i, nullptr});
+		}
+		else if (source->getType() == CONTAINER)
+			stores.push_back({field, 0, source});
+		else
+			return nullptr;
+	}
+	return std::make_shared<const std::vector<field_store_t>>(stores);
+}
+
 DefineI::DefineI(const hash_ull &key, const signature_t &ftype, const std::vector<std::pair<bool, hash_ull>> &params, const ptr_instruction_t &body, const std::vector<hash_ull> &captures, const token_t &token)
-	: Instruction(DEFINE, token), key{key}, ftype{ftype}, params{params}, body{body}, captures{captures}
+	: Instruction(DEFINE, token), key{key}, ftype{ftype}, params{params}, body{body}, captures{captures}, stores{key == parser_t::HASH_INIT ? compileFieldStores(params, body, captures) : nullptr}
 {
 }
 
 const symbol_t DefineI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
-	std::map<const hash_ull, const symbol_t> capturedVars;
-	for (const hash_ull &e : captures)
-	{
-		capturedVars[e].set(&scope->getVariable(e, &token, stack_trace), &token, stack_trace);
-	}
-	ptr_function_t f = std::make_shared<function_t>(key, scope->getPtr(), params, body, capturedVars);
+	stats::countInstruction(type);
+	ptr_function_t f = std::make_shared<function_t>(key, scope->getPtr(), params, body, captureScope(scope, captures, &token, stack_trace), stores);
 	if (key > 0)
 	{
 		return scope->createVariable(key, symbol_t::FunctionSIG(ftype, f), &token);
@@ -116,12 +198,8 @@ VargDefineI::VargDefineI(const hash_ull &key, const ptr_instruction_t &body, con
 
 const symbol_t VargDefineI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
-	std::map<const hash_ull, const symbol_t> capturedVars;
-	for (const hash_ull &e : captures)
-	{
-		capturedVars[e].set(&scope->getVariable(e, &token, stack_trace), &token, stack_trace);
-	}
-	ptr_function_t f = std::make_shared<function_t>(key, scope->getPtr(), body, capturedVars);
+	stats::countInstruction(type);
+	ptr_function_t f = std::make_shared<function_t>(key, scope->getPtr(), body, captureScope(scope, captures, &token, stack_trace));
 	if (key > 0)
 	{
 		return scope->createVariable(key, symbol_t::FunctionVARG(static_cast<ptr_function_t>(f)), &token);
@@ -140,6 +218,7 @@ SequenceI::SequenceI(const std::vector<ptr_instruction_t> &children, const token
 
 const symbol_t SequenceI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	std::vector<symbol_t> evals;
 	for (const ptr_instruction_t &e : children)
 	{
@@ -177,6 +256,7 @@ IfThenElseI::IfThenElseI(const ptr_instruction_t &ifs, const ptr_instruction_t &
 
 const symbol_t IfThenElseI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const object_t newScope(scope, 0);
 	if (ifs->evaluate(&newScope, stack_trace).getBool(&token, stack_trace))
 	{
@@ -196,6 +276,7 @@ IfThenI::IfThenI(const ptr_instruction_t &ifs, const ptr_instruction_t &body, co
 
 const symbol_t IfThenI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const object_t newScope(scope, 0);
 	if (ifs->evaluate(&newScope, stack_trace).getBool(&token, stack_trace))
 	{
@@ -215,6 +296,7 @@ WhileI::WhileI(const ptr_instruction_t &whiles, const std::vector<ptr_instructio
 
 const symbol_t WhileI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	while (whiles->evaluate(scope, stack_trace).getBool(&token, stack_trace))
 	{
 		const object_t newScope(scope, OBJECT_WEAK);
@@ -253,6 +335,7 @@ ForI::ForI(const hash_ull &id, const ptr_instruction_t &fors, const std::vector<
 
 const symbol_t ForI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const std::vector<symbol_t> evalFor = fors->evaluate(scope, stack_trace).getVector(&token, stack_trace);
 	for (auto &&e : evalFor)
 	{
@@ -293,6 +376,7 @@ VariableI::VariableI(const hash_ull &key, const token_t &token)
 
 const symbol_t VariableI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return scope->getVariable(key, &token, stack_trace);
 }
 
@@ -307,6 +391,7 @@ GetThisI::GetThisI(const token_t &token)
 
 const symbol_t GetThisI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return scope->getThis(&token, stack_trace);
 }
 
@@ -321,18 +406,12 @@ DeclareI::DeclareI(const hash_ull &key, const ptr_instruction_t &a, const bool &
 
 const symbol_t DeclareI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t v = scope->createVariable(key, &token);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	if (scope->hasValue(parser_t::HASH_SET) && evalA.getValueType() == value_type_enum::OBJECT)
 	{
-		ptr_function_t f = nullptr;
-		try
-		{
-			f = scope->getVariable(parser_t::HASH_SET, &token, stack_trace).getFunction({v, evalA}, &token, stack_trace);
-		}
-		catch (const rossa_error_t &e)
-		{
-		}
+		const ptr_function_t f = scope->getVariable(parser_t::HASH_SET, &token, stack_trace).tryGetFunction({v, evalA}, stack_trace);
 		if (f)
 		{
 			function_evaluate(f, {v, evalA}, &token, stack_trace);
@@ -354,6 +433,7 @@ IndexI::IndexI(const ptr_instruction_t &a, const ptr_instruction_t &b, const tok
 
 const symbol_t IndexI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -371,6 +451,7 @@ InnerI::InnerI(const ptr_instruction_t &a, const ptr_instruction_t &b, const tok
 
 const symbol_t InnerI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	switch (evalA.getValueType())
 	{
@@ -397,9 +478,41 @@ CallI::CallI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token
 
 const symbol_t CallI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return operation::call(scope, a, b->evaluate(scope, stack_trace).getVector(&token, stack_trace), &token, stack_trace);
 }
 
+// Same as evaluate(), but a plain function call is handed to the enclosing frame's tail call slot when
+// none of the callee's parents die with that frame, and no argument holds a closure or object that still
+// resolves names through it
+const symbol_t CallI::evaluateTail(const object_t *scope, trace_t &stack_trace) const
+{
+	stats::countInstruction(type);
+	const std::vector<symbol_t> args = b->evaluate(scope, stack_trace).getVector(&token, stack_trace);
+	const symbol_t evalA = a->evaluate(scope, stack_trace);
+
+	if (evalA.getValueType() == value_type_enum::OBJECT)
+	{
+		const auto &o = evalA.getObject(&token, stack_trace);
+		if (o->hasValue(parser_t::HASH_CALL))
+			return o->getVariable(parser_t::HASH_CALL, &token, stack_trace).call(args, &token, stack_trace);
+	}
+
+	const ptr_function_t f = evalA.getFunction(args, &token, stack_trace);
+	tail_call_t *slot = tailCallSlot;
+	bool safe = slot != NULL && f->outlives(slot->frame);
+	size_t budget = TAIL_CALL_SCAN;
+	for (size_t i = 0; safe && i < args.size(); i++)
+		safe = args[i].outlives(slot->frame, budget);
+	if (!safe)
+		return function_evaluate(f, args, &token, stack_trace);
+
+	slot->function = f;
+	slot->params = args;
+	slot->token = token;
+	return symbol_t();
+}
+
 /*-------------------------------------------------------------------------------------------------------*/
 /*class CallWithInnerI                                                                                   */
 /*-------------------------------------------------------------------------------------------------------*/
@@ -411,6 +524,7 @@ CallWithInnerI::CallWithInnerI(const ptr_instruction_t &a, const ptr_instruction
 
 const symbol_t CallWithInnerI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return operation::callWithInner(scope, a, b->evaluate(scope, stack_trace).getVector(&token, stack_trace), &token, stack_trace);
 }
 
@@ -425,6 +539,7 @@ AddI::AddI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t AddI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -442,6 +557,7 @@ SubI::SubI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t SubI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -459,6 +575,7 @@ MulI::MulI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t MulI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -476,6 +593,7 @@ DivI::DivI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t DivI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -493,6 +611,7 @@ ModI::ModI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t ModI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -510,6 +629,7 @@ PowI::PowI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t PowI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -527,6 +647,7 @@ LessI::LessI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token
 
 const symbol_t LessI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -544,6 +665,7 @@ MoreI::MoreI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token
 
 const symbol_t MoreI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -561,6 +683,7 @@ ELessI::ELessI(const ptr_instruction_t &a, const ptr_instruction_t &b, const tok
 
 const symbol_t ELessI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -578,6 +701,7 @@ EMoreI::EMoreI(const ptr_instruction_t &a, const ptr_instruction_t &b, const tok
 
 const symbol_t EMoreI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -595,6 +719,7 @@ EqualsI::EqualsI(const ptr_instruction_t &a, const ptr_instruction_t &b, const t
 
 const symbol_t EqualsI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -615,6 +740,7 @@ NEqualsI::NEqualsI(const ptr_instruction_t &a, const ptr_instruction_t &b, const
 
 const symbol_t NEqualsI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -635,6 +761,7 @@ AndI::AndI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t AndI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	if (!a->evaluate(scope, stack_trace).getBool(&token, stack_trace))
 		return symbol_t::Boolean(false);
 	if (b->evaluate(scope, stack_trace).getBool(&token, stack_trace))
@@ -653,6 +780,7 @@ OrI::OrI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t &
 
 const symbol_t OrI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	if (a->evaluate(scope, stack_trace).getBool(&token, stack_trace))
 		return symbol_t::Boolean(true);
 	if (b->evaluate(scope, stack_trace).getBool(&token, stack_trace))
@@ -671,6 +799,7 @@ BOrI::BOrI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t BOrI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -688,6 +817,7 @@ BXOrI::BXOrI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token
 
 const symbol_t BXOrI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -705,6 +835,7 @@ BAndI::BAndI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token
 
 const symbol_t BAndI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -722,6 +853,7 @@ BShiftLeftI::BShiftLeftI(const ptr_instruction_t &a, const ptr_instruction_t &b,
 
 const symbol_t BShiftLeftI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -739,6 +871,7 @@ BShiftRightI::BShiftRightI(const ptr_instruction_t &a, const ptr_instruction_t &
 
 const symbol_t BShiftRightI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -756,19 +889,13 @@ SetI::SetI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t SetI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
 	if (scope->hasValue(parser_t::HASH_SET) && ((evalA.getValueType() == value_type_enum::OBJECT && !evalA.getObject(&token, stack_trace)->hasValue(parser_t::HASH_SET)) || evalB.getValueType() == value_type_enum::OBJECT))
 	{
-		ptr_function_t f = nullptr;
-		try
-		{
-			f = scope->getVariable(parser_t::HASH_SET, &token, stack_trace).getFunction({evalA, evalB}, &token, stack_trace);
-		}
-		catch (const rossa_error_t &e)
-		{
-		}
+		const ptr_function_t f = scope->getVariable(parser_t::HASH_SET, &token, stack_trace).tryGetFunction({evalA, evalB}, stack_trace);
 		if (f)
 		{
 			function_evaluate(f, {evalA, evalB}, &token, stack_trace);
@@ -790,7 +917,10 @@ ReturnI::ReturnI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t ReturnI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
-	symbol_t evalA = a->evaluate(scope, stack_trace);
+	stats::countInstruction(type);
+	symbol_t evalA = (tailCallSlot != NULL && a->getType() == CALL_I
+						  ? reinterpret_cast<const CallI *>(a.get())->evaluateTail(scope, stack_trace)
+						  : a->evaluate(scope, stack_trace));
 	evalA.setSymbolType(symbol_t::type_t::ID_RETURN);
 	return evalA;
 }
@@ -807,6 +937,7 @@ ExternI::ExternI(const std::string &libname, const std::string &fname, const ptr
 
 const symbol_t ExternI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	auto evalA = a->evaluate(scope, stack_trace);
 	std::vector<mediator_t> mv;
 	for (auto &e : evalA.getVector(&token, stack_trace))
@@ -834,6 +965,7 @@ LengthI::LengthI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t LengthI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	switch (evalA.getValueType())
 	{
@@ -883,6 +1015,7 @@ ClassI::ClassI(const hash_ull &key, const scope_type_enum &type, const ptr_instr
 
 const symbol_t ClassI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	ptr_instruction_t nbody = body;
 	object_t *ex = NULL;
 	std::vector<aug_type_t> extensions;
@@ -920,6 +1053,7 @@ NewI::NewI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token_t
 
 const symbol_t NewI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const auto &base = a->evaluate(scope, stack_trace).getObject(&token, stack_trace);
 	return base->instantiate(b->evaluate(scope, stack_trace).getVector(&token, stack_trace), &token, stack_trace);
 }
@@ -935,6 +1069,7 @@ CastToI::CastToI(const ptr_instruction_t &a, const ptr_instruction_t &b, const t
 
 const symbol_t CastToI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const parameter_t convert = b->evaluate(scope, stack_trace).getTypeName(&token, stack_trace);
 
@@ -1156,6 +1291,7 @@ AllocI::AllocI(const ptr_instruction_t &a, const ptr_instruction_t &setall, cons
 
 const symbol_t AllocI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const long_int_t evalA = a->evaluate(scope, stack_trace).getNumber(&token, stack_trace).getLong();
 	if (evalA < 0)
 		throw rossa_error_t(_FAILURE_ALLOC_, token, stack_trace);
@@ -1178,6 +1314,7 @@ UntilStepExcI::UntilStepExcI(const ptr_instruction_t &a, const ptr_instruction_t
 
 const symbol_t UntilStepExcI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -1195,6 +1332,7 @@ UntilNoStepExcI::UntilNoStepExcI(const ptr_instruction_t &a, const ptr_instructi
 
 const symbol_t UntilNoStepExcI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -1212,6 +1350,7 @@ UntilStepIncI::UntilStepIncI(const ptr_instruction_t &a, const ptr_instruction_t
 
 const symbol_t UntilStepIncI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -1229,6 +1368,7 @@ UntilNoStepIncI::UntilNoStepIncI(const ptr_instruction_t &a, const ptr_instructi
 
 const symbol_t UntilNoStepIncI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -1244,8 +1384,14 @@ ScopeI::ScopeI(const std::vector<ptr_instruction_t> &children, const token_t &to
 {
 }
 
+const std::vector<ptr_instruction_t> &ScopeI::getChildren() const
+{
+	return children;
+}
+
 const symbol_t ScopeI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	for (const ptr_instruction_t &e : children)
 	{
 		const symbol_t eval = e->evaluate(scope, stack_trace);
@@ -1266,6 +1412,7 @@ MapI::MapI(const std::map<std::string, ptr_instruction_t> &children, const token
 
 const symbol_t MapI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	std::map<const std::string, const symbol_t> evals;
 	for (auto &&e : children)
 	{
@@ -1288,6 +1435,7 @@ ReferI::ReferI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t ReferI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	symbol_t evalA = a->evaluate(scope, stack_trace);
 	evalA.setSymbolType(symbol_t::type_t::ID_REFER);
 	return evalA;
@@ -1304,6 +1452,7 @@ SwitchI::SwitchI(const ptr_instruction_t &switchs, const std::map<symbol_t, size
 
 const symbol_t SwitchI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const object_t newScope(scope, 0);
 	const symbol_t eval = switchs->evaluate(&newScope, stack_trace);
 	size_t index = 0;
@@ -1348,13 +1497,19 @@ TryCatchI::TryCatchI(const ptr_instruction_t &a, const ptr_instruction_t &b, con
 
 const symbol_t TryCatchI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
+	const size_t depth = stack_trace.size();
 	try
 	{
+		// A tail call would run the callee outside of this handler
+		const tail_guard_t guard(NULL);
 		const object_t newScope(scope, 0);
 		return a->evaluate(&newScope, stack_trace);
 	}
 	catch (const rossa_error_t &e)
 	{
+		// Frames abandoned by the throw were never popped
+		stack_trace.erase(stack_trace.begin() + depth, stack_trace.end());
 		const object_t newScope(scope, 0);
 		newScope.createVariable(key, symbol_t::String(std::string(e.what())), &token);
 		return b->evaluate(&newScope, stack_trace);
@@ -1372,6 +1527,7 @@ ThrowI::ThrowI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t ThrowI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	throw rossa_error_t(evalA.getString(&token, stack_trace), token, stack_trace);
 	return symbol_t();
@@ -1388,6 +1544,7 @@ PureEqualsI::PureEqualsI(const ptr_instruction_t &a, const ptr_instruction_t &b,
 
 const symbol_t PureEqualsI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 	return symbol_t::Boolean(evalA.pureEquals(&evalB, &token, stack_trace));
@@ -1404,6 +1561,7 @@ PureNEqualsI::PureNEqualsI(const ptr_instruction_t &a, const ptr_instruction_t &
 
 const symbol_t PureNEqualsI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 	return symbol_t::Boolean(evalA.pureNEquals(&evalB, &token, stack_trace));
@@ -1420,6 +1578,7 @@ CharNI::CharNI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t CharNI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const std::string evalA = a->evaluate(scope, stack_trace).getString(&token, stack_trace);
 	std::vector<symbol_t> nv;
 	for (auto &&c : evalA)
@@ -1438,6 +1597,7 @@ CharSI::CharSI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t CharSI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	switch (evalA.getValueType())
 	{
@@ -1467,6 +1627,7 @@ DeclareVarsI::DeclareVarsI(const std::vector<hash_ull> &keys, const token_t &tok
 
 const symbol_t DeclareVarsI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	std::vector<symbol_t> newvs;
 	for (const hash_ull &k : keys)
 		newvs.push_back(scope->createVariable(k, &token));
@@ -1484,16 +1645,32 @@ ParseI::ParseI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t ParseI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const std::string evalA = a->evaluate(scope, stack_trace).getString(&token, stack_trace);
 
 	const std::vector<token_t> tokens = lexString(evalA, std::filesystem::current_path() / KEYWORD_NIL);
 	node_parser_t np(tokens, std::filesystem::current_path() / KEYWORD_NIL);
 
-	std::vector<std::pair<std::vector<hash_ull>, symbol_t>> consts;
+	const_table_t consts;
 	std::vector<node_scope_t> scopes;
 	return np.parse(&scopes, &consts)->fold(consts)->genParser()->evaluate(scope, stack_trace);
 }
 
+/*-------------------------------------------------------------------------------------------------------*/
+/*class CollectI                                                                                        */
+/*-------------------------------------------------------------------------------------------------------*/
+
+CollectI::CollectI(const token_t &token)
+	: Instruction(COLLECT_I, token)
+{
+}
+
+const symbol_t CollectI::evaluate(const object_t *scope, trace_t &stack_trace) const
+{
+	stats::countInstruction(type);
+	return collector_t::getStats(collector_t::collect());
+}
+
 /*-------------------------------------------------------------------------------------------------------*/
 /*class BNotI                                                                                           */
 /*-------------------------------------------------------------------------------------------------------*/
@@ -1505,6 +1682,7 @@ BNotI::BNotI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t BNotI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return operation::bnot(
 		scope,
 		a->evaluate(scope, stack_trace),
@@ -1523,6 +1701,7 @@ TypeI::TypeI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t TypeI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return symbol_t::TypeName(a->evaluate(scope, stack_trace).getAugValueType());
 }
 
@@ -1537,6 +1716,7 @@ CallOpI::CallOpI(const size_t &id, const std::vector<ptr_instruction_t> &childre
 
 const symbol_t CallOpI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	switch (id)
 	{
 	case 0:
@@ -1697,6 +1877,7 @@ DeleteI::DeleteI(const ptr_instruction_t &a, const ptr_instruction_t &b, const t
 
 const symbol_t DeleteI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 	return operation::del(scope, evalA, evalB, &token, stack_trace);
@@ -1713,6 +1894,7 @@ UnAddI::UnAddI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t UnAddI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return operation::unadd(scope, a->evaluate(scope, stack_trace), &token, stack_trace);
 }
 
@@ -1727,6 +1909,7 @@ NegI::NegI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t NegI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return operation::neg(scope, a->evaluate(scope, stack_trace), &token, stack_trace);
 }
 
@@ -1741,6 +1924,7 @@ NotI::NotI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t NotI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return operation::unot(scope, a->evaluate(scope, stack_trace), &token, stack_trace);
 }
 
@@ -1755,6 +1939,7 @@ ConcatI::ConcatI(const ptr_instruction_t &a, const ptr_instruction_t &b, const t
 
 const symbol_t ConcatI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -1772,6 +1957,7 @@ SetIndexI::SetIndexI(const ptr_instruction_t &a, const ptr_instruction_t &b, con
 
 const symbol_t SetIndexI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	auto evalA = a->evaluate(scope, stack_trace);
 	auto evalAVector = evalA.getVector(&token, stack_trace);
 	auto evalBVector = b->evaluate(scope, stack_trace).getVector(&token, stack_trace);
@@ -1797,6 +1983,7 @@ HashI::HashI(const ptr_instruction_t &a, const token_t &token)
 
 const symbol_t HashI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	return operation::hash(scope, a->evaluate(scope, stack_trace), &token, stack_trace);
 }
 
@@ -1811,6 +1998,7 @@ EachI::EachI(const hash_ull &id, const ptr_instruction_t &eachs, const ptr_instr
 
 const symbol_t EachI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const std::vector<symbol_t> evalFor = eachs->evaluate(scope, stack_trace).getVector(&token, stack_trace);
 	std::vector<symbol_t> list;
 	for (const symbol_t &e : evalFor)
@@ -1848,6 +2036,7 @@ FDivI::FDivI(const ptr_instruction_t &a, const ptr_instruction_t &b, const token
 
 const symbol_t FDivI::evaluate(const object_t *scope, trace_t &stack_trace) const
 {
+	stats::countInstruction(type);
 	const symbol_t evalA = a->evaluate(scope, stack_trace);
 	const symbol_t evalB = b->evaluate(scope, stack_trace);
 
@@ -79,7 +79,8 @@ enum instruction_type_enum
 	EACH_I,
 	FDIV_I,
 	CALL_I,
-	CALL_INNER_I
+	CALL_INNER_I,
+	COLLECT_I
 };
 
 class Instruction
@@ -158,6 +159,7 @@ protected:
 	const std::vector<std::pair<bool, hash_ull>> params;
 	const ptr_instruction_t body;
 	const std::vector<hash_ull> captures;
+	const std::shared_ptr<const std::vector<field_store_t>> stores;
 
 public:
 	DefineI(const hash_ull &, const signature_t &, const std::vector<std::pair<bool, hash_ull>> &, const ptr_instruction_t &, const std::vector<hash_ull> &, const token_t &);
@@ -323,6 +325,7 @@ class CallI : public BinaryI
 public:
 	CallI(const ptr_instruction_t &, const ptr_instruction_t &, const token_t &);
 	const symbol_t evaluate(const object_t *, trace_t &) const override;
+	const symbol_t evaluateTail(const object_t *, trace_t &) const;
 };
 
 /**
@@ -713,6 +716,7 @@ protected:
 public:
 	ScopeI(const std::vector<ptr_instruction_t> &, const token_t &);
 	const symbol_t evaluate(const object_t *, trace_t &) const override;
+	const std::vector<ptr_instruction_t> &getChildren() const;
 };
 
 /**
@@ -848,6 +852,17 @@ public:
 	const symbol_t evaluate(const object_t *, trace_t &) const override;
 };
 
+/**
+ * Run the cycle collector
+ * `gc()`
+ */
+class CollectI : public Instruction
+{
+public:
+	CollectI(const token_t &);
+	const symbol_t evaluate(const object_t *, trace_t &) const override;
+};
+
 /**
  * Get value type
  * `$ <EXPR>`
@@ -26,6 +26,30 @@ const std::string deHashVec(const std::vector<node_scope_t> &t)
 	return ret;
 }
 
+// Resolves `suffix` against the constant table from the innermost enclosing scope outwards
+static const symbol_t *findConst(const const_table_t &consts, const std::vector<node_scope_t> &path, const std::vector<hash_ull> &suffix)
+{
+	if (consts.empty())
+		return NULL;
+	std::vector<hash_ull> key;
+	key.reserve(path.size() + suffix.size());
+	for (auto &p : path)
+		key.push_back(p.id);
+	size_t depth = path.size();
+	while (true)
+	{
+		key.insert(key.end(), suffix.begin(), suffix.end());
+		auto it = consts.find(key);
+		if (it != consts.end())
+			return &it->second;
+		if (depth == 0)
+			return NULL;
+		key.resize(--depth);
+	}
+}
+
+thread_local size_t Node::rewrites = 0;
+
 Node::Node(const std::vector<node_scope_t> &path, const type_t &type, const token_t &token)
 	: path(path), type(type), token(token)
 {
@@ -75,7 +99,7 @@ void ContainerNode::printTree(std::string indent, bool last) const
 	std::cout << "CONTAINER : " << s.toCodeString() << "\n";
 }
 
-const ptr_node_t ContainerNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ContainerNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<ContainerNode>(path, s, token);
 }
@@ -132,7 +156,7 @@ void VectorNode::printTree(std::string indent, bool last) const
 			args[i]->printTree(indent, i == args.size() - 1);
 }
 
-const ptr_node_t VectorNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t VectorNode::fold(const const_table_t &consts) const
 {
 	if (isConst())
 	{
@@ -140,6 +164,7 @@ const ptr_node_t VectorNode::fold(const std::vector<std::pair<std::vector<hash_u
 		object_t newScope(static_cast<hash_ull>(0));
 		trace_t stack_trace;
 		auto r = i->evaluate(&newScope, stack_trace);
+		Node::rewrites++;
 		return std::make_shared<ContainerNode>(path, r, token);
 	}
 
@@ -191,7 +216,7 @@ void BreakNode::printTree(std::string indent, bool last) const
 	std::cout << "BREAK\n";
 }
 
-const ptr_node_t BreakNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t BreakNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<ContainerNode>(path, symbol_t(symbol_t::type_t::ID_BREAK), token);
 }
@@ -232,7 +257,7 @@ void ContinueNode::printTree(std::string indent, bool last) const
 	std::cout << "CONTINUE\n";
 }
 
-const ptr_node_t ContinueNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ContinueNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<ContainerNode>(path, symbol_t(symbol_t::type_t::ID_CONTINUE), token);
 }
@@ -282,7 +307,7 @@ void IDNode::printTree(std::string indent, bool last) const
 	std::cout << "ID : " << ROSSA_DEHASH(key) << "\n";
 }
 
-const ptr_node_t IDNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t IDNode::fold(const const_table_t &consts) const
 {
 	bool flag = true;
 	for (auto &p : path)
@@ -296,22 +321,10 @@ const ptr_node_t IDNode::fold(const std::vector<std::pair<std::vector<hash_ull>,
 
 	if (flag)
 	{
-		for (auto &c : consts)
+		if (auto c = findConst(consts, path, {key}))
 		{
-			std::vector<hash_ull> tpath;
-			for (auto &p : path)
-				tpath.push_back(p.id);
-			while (true)
-			{
-				auto temp = tpath;
-				temp.push_back({key});
-
-				if (c.first == temp)
-					return std::make_shared<ContainerNode>(path, c.second, token);
-				if (tpath.empty())
-					break;
-				tpath.pop_back();
-			}
+			Node::rewrites++;
+			return std::make_shared<ContainerNode>(path, *c, token);
 		}
 	}
 
@@ -361,7 +374,7 @@ void BIDNode::printTree(std::string indent, bool last) const
 	std::cout << "BID : " << key << "\n";
 }
 
-const ptr_node_t BIDNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t BIDNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<BIDNode>(path, key, token);
 }
@@ -413,7 +426,7 @@ void DefineNode::printTree(std::string indent, bool last) const
 	body->printTree(indent, true);
 }
 
-const ptr_node_t DefineNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t DefineNode::fold(const const_table_t &consts) const
 {
 	if (isConst())
 	{
@@ -421,6 +434,7 @@ const ptr_node_t DefineNode::fold(const std::vector<std::pair<std::vector<hash_u
 		object_t newScope(static_cast<hash_ull>(0));
 		trace_t stack_trace;
 		auto r = i->evaluate(&newScope, stack_trace);
+		Node::rewrites++;
 		return std::make_shared<ContainerNode>(path, r, token);
 	}
 
@@ -470,7 +484,7 @@ void VargDefineNode::printTree(std::string indent, bool last) const
 	body->printTree(indent, true);
 }
 
-const ptr_node_t VargDefineNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t VargDefineNode::fold(const const_table_t &consts) const
 {
 	if (isConst())
 	{
@@ -478,6 +492,7 @@ const ptr_node_t VargDefineNode::fold(const std::vector<std::pair<std::vector<ha
 		object_t newScope(static_cast<hash_ull>(0));
 		trace_t stack_trace;
 		auto r = i->evaluate(&newScope, stack_trace);
+		Node::rewrites++;
 		return std::make_shared<ContainerNode>(path, r, token);
 	}
 
@@ -527,7 +542,7 @@ void NewNode::printTree(std::string indent, bool last) const
 	params->printTree(indent, true);
 }
 
-const ptr_node_t NewNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t NewNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<NewNode>(path, object->fold(consts), params->fold(consts), token);
 }
@@ -605,7 +620,7 @@ void ClassNode::printTree(std::string indent, bool last) const
 		body[i]->printTree(indent, i == body.size() - 1);
 }
 
-const ptr_node_t ClassNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ClassNode::fold(const const_table_t &consts) const
 {
 	std::vector<ptr_node_t> nbody;
 	for (auto &c : body)
@@ -655,7 +670,7 @@ void VarNode::printTree(std::string indent, bool last) const
 	std::cout << "VAR : " << keys.size() << "\n";
 }
 
-const ptr_node_t VarNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t VarNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<VarNode>(path, keys, token);
 }
@@ -721,7 +736,7 @@ void CallNode::printTree(std::string indent, bool last) const
 		args[i]->printTree(indent, i == args.size() - 1);
 }
 
-const ptr_node_t CallNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t CallNode::fold(const const_table_t &consts) const
 {
 	std::vector<ptr_node_t> nargs;
 	for (auto &c : args)
@@ -777,7 +792,7 @@ void ExternCallNode::printTree(std::string indent, bool last) const
 		args[i]->printTree(indent, i == args.size() - 1);
 }
 
-const ptr_node_t ExternCallNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ExternCallNode::fold(const const_table_t &consts) const
 {
 	std::vector<ptr_node_t> nargs;
 	for (auto &c : args)
@@ -844,6 +859,12 @@ ptr_instruction_t CallBuiltNode::genParser() const
 			throw rossa_error_t(util::format(_TOO_MANY_ARGUMENTS_, {KEYWORD_CHAR_S}), token, stack_trace);
 		}
 		return std::make_shared<CharSI>(args[0]->genParser(), token);
+	case TOK_GC:
+		if (args.size() > 0)
+		{
+			throw rossa_error_t(util::format(_TOO_MANY_ARGUMENTS_, {KEYWORD_GC}), token, stack_trace);
+		}
+		return std::make_shared<CollectI>(token);
 	default:
 		break;
 	}
@@ -854,6 +875,8 @@ ptr_instruction_t CallBuiltNode::genParser() const
 
 bool CallBuiltNode::isConst() const
 {
+	if (t == TOK_GC)
+		return false;
 	for (auto &arg : args)
 	{
 		if (!arg->isConst())
@@ -885,7 +908,7 @@ void CallBuiltNode::printTree(std::string indent, bool last) const
 	}
 }
 
-const ptr_node_t CallBuiltNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t CallBuiltNode::fold(const const_table_t &consts) const
 {
 	if (isConst())
 	{
@@ -893,6 +916,7 @@ const ptr_node_t CallBuiltNode::fold(const std::vector<std::pair<std::vector<has
 		object_t newScope(static_cast<hash_ull>(0));
 		trace_t stack_trace;
 		auto r = i->evaluate(&newScope, stack_trace);
+		Node::rewrites++;
 		return std::make_shared<ContainerNode>(path, r, token);
 	}
 
@@ -944,7 +968,7 @@ void ReturnNode::printTree(std::string indent, bool last) const
 	a->printTree(indent, true);
 }
 
-const ptr_node_t ReturnNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ReturnNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<ReturnNode>(path, a->fold(consts), token);
 }
@@ -988,7 +1012,7 @@ void ReferNode::printTree(std::string indent, bool last) const
 	a->printTree(indent, true);
 }
 
-const ptr_node_t ReferNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ReferNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<ReferNode>(path, a->fold(consts), token);
 }
@@ -1154,7 +1178,7 @@ void BinOpNode::printTree(std::string indent, bool last) const
 	b->printTree(indent, true);
 }
 
-const ptr_node_t BinOpNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t BinOpNode::fold(const const_table_t &consts) const
 {
 	if (op == "+=")
 		return std::make_shared<BinOpNode>(path, "=", a, std::make_shared<BinOpNode>(path, "+", a, b, token), token)->fold(consts);
@@ -1189,34 +1213,43 @@ const ptr_node_t BinOpNode::fold(const std::vector<std::pair<std::vector<hash_ul
 
 	auto na = a->fold(consts);
 	auto nb = b->fold(consts);
+	auto ret = std::make_shared<BinOpNode>(path, op, na, nb, token);
 
-	bool constmod = false;
-
-	if (a->isConst() && b->isConst())
+	if (na->isConst() && nb->isConst())
 	{
 		try
 		{
 			object_t newScope(static_cast<hash_ull>(0));
 			trace_t stack_trace;
-			genParser()->evaluate(&newScope, stack_trace);
-			constmod = true;
+			auto r = ret->genParser()->evaluate(&newScope, stack_trace);
+			Node::rewrites++;
+			return std::make_shared<ContainerNode>(path, r, token);
 		}
 		catch (const rossa_error_t &e)
 		{
 		}
 	}
 
-	if (constmod)
+	// `false && x` and `true || x` never evaluate x
+	if (parser_t::optLevel >= 2 && (op == "&&" || op == "||") && na->isConst())
 	{
-		object_t newScope(static_cast<hash_ull>(0));
-		trace_t stack_trace;
-		auto evalA = na->genParser()->evaluate(&newScope, stack_trace);
-		auto evalB = nb->genParser()->evaluate(&newScope, stack_trace);
-		auto r = genParser()->evaluate(&newScope, stack_trace);
-		return std::make_shared<ContainerNode>(path, r, token);
+		try
+		{
+			object_t newScope(static_cast<hash_ull>(0));
+			trace_t stack_trace;
+			auto cond = na->genParser()->evaluate(&newScope, stack_trace).getBool(&token, stack_trace);
+			if (cond == (op == "||"))
+			{
+				Node::rewrites++;
+				return std::make_shared<ContainerNode>(path, symbol_t::Boolean(cond), token);
+			}
+		}
+		catch (const rossa_error_t &e)
+		{
+		}
 	}
 
-	return std::make_shared<BinOpNode>(path, op, na, b->fold(consts), token);
+	return ret;
 }
 
 //------------------------------------------------------------------------------------------------------
@@ -1275,7 +1308,7 @@ void UnOpNode::printTree(std::string indent, bool last) const
 	a->printTree(indent, true);
 }
 
-const ptr_node_t UnOpNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t UnOpNode::fold(const const_table_t &consts) const
 {
 	auto na = a->fold(consts);
 	auto ru = std::make_shared<UnOpNode>(path, op, na, token);
@@ -1284,6 +1317,7 @@ const ptr_node_t UnOpNode::fold(const std::vector<std::pair<std::vector<hash_ull
 		object_t newScope(static_cast<hash_ull>(0));
 		trace_t stack_trace;
 		auto r = ru->genParser()->evaluate(&newScope, stack_trace);
+		Node::rewrites++;
 		return std::make_shared<ContainerNode>(path, r, token);
 	}
 
@@ -1329,7 +1363,7 @@ void ParenNode::printTree(std::string indent, bool last) const
 	a->printTree(indent, true);
 }
 
-const ptr_node_t ParenNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ParenNode::fold(const const_table_t &consts) const
 {
 	return a->fold(consts);
 }
@@ -1386,7 +1420,7 @@ void InsNode::printTree(std::string indent, bool last) const
 	arg->printTree(indent, true);
 }
 
-const ptr_node_t InsNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t InsNode::fold(const const_table_t &consts) const
 {
 	if (arg->getType() == ID_NODE)
 	{
@@ -1425,23 +1459,10 @@ const ptr_node_t InsNode::fold(const std::vector<std::pair<std::vector<hash_ull>
 		}
 		fpath.push_back(reinterpret_cast<IDNode *>(arg.get())->getKey());
 
-		for (auto &c : consts)
+		if (auto c = findConst(consts, path, fpath))
 		{
-			std::vector<hash_ull> tpath;
-			for (auto &p : path)
-				tpath.push_back(p.id);
-			while (true)
-			{
-				auto temp = tpath;
-				for (auto &p : fpath)
-					temp.push_back(p);
-
-				if (c.first == temp)
-					return std::make_shared<ContainerNode>(path, c.second, token);
-				if (tpath.empty())
-					break;
-				tpath.pop_back();
-			}
+			Node::rewrites++;
+			return std::make_shared<ContainerNode>(path, *c, token);
 		}
 	}
 
@@ -1513,7 +1534,7 @@ void IfElseNode::printTree(std::string indent, bool last) const
 		elses->printTree(indent, true);
 }
 
-const ptr_node_t IfElseNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t IfElseNode::fold(const const_table_t &consts) const
 {
 	auto nifs = ifs->fold(consts);
 	auto nbody = body->fold(consts);
@@ -1527,9 +1548,36 @@ const ptr_node_t IfElseNode::fold(const std::vector<std::pair<std::vector<hash_u
 		object_t newScope(static_cast<hash_ull>(0));
 		trace_t stack_trace;
 		auto r = i->evaluate(&newScope, stack_trace);
+		Node::rewrites++;
 		return std::make_shared<ContainerNode>(path, r, token);
 	}
 
+	// Drop the branch that can never run; the survivor stays under `if (true)` so it keeps its own scope
+	if (parser_t::optLevel >= 2 && nifs->isConst())
+	{
+		try
+		{
+			object_t newScope(static_cast<hash_ull>(0));
+			trace_t stack_trace;
+			auto cond = nifs->genParser()->evaluate(&newScope, stack_trace).getBool(&token, stack_trace);
+			if (!cond)
+			{
+				Node::rewrites++;
+				if (nelses)
+					return std::make_shared<IfElseNode>(path, std::make_shared<ContainerNode>(path, symbol_t::Boolean(true), token), nelses, token);
+				return std::make_shared<ContainerNode>(path, symbol_t(), token);
+			}
+			if (nelses)
+			{
+				Node::rewrites++;
+				return std::make_shared<IfElseNode>(path, nifs, nbody, token);
+			}
+		}
+		catch (const rossa_error_t &e)
+		{
+		}
+	}
+
 	auto ret = std::make_shared<IfElseNode>(path, nifs, nbody, token);
 	if (nelses)
 		ret->setElse(nelses);
@@ -1585,12 +1633,30 @@ void WhileNode::printTree(std::string indent, bool last) const
 		body[i]->printTree(indent, i == body.size() - 1);
 }
 
-const ptr_node_t WhileNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t WhileNode::fold(const const_table_t &consts) const
 {
+	auto nwhiles = whiles->fold(consts);
+	if (parser_t::optLevel >= 2 && nwhiles->isConst())
+	{
+		try
+		{
+			object_t newScope(static_cast<hash_ull>(0));
+			trace_t stack_trace;
+			if (!nwhiles->genParser()->evaluate(&newScope, stack_trace).getBool(&token, stack_trace))
+			{
+				Node::rewrites++;
+				return std::make_shared<ContainerNode>(path, symbol_t(), token);
+			}
+		}
+		catch (const rossa_error_t &e)
+		{
+		}
+	}
+
 	std::vector<ptr_node_t> nbody;
 	for (auto &c : body)
 		nbody.push_back(c->fold(consts));
-	return std::make_shared<WhileNode>(path, whiles->fold(consts), nbody, token);
+	return std::make_shared<WhileNode>(path, nwhiles, nbody, token);
 }
 
 //------------------------------------------------------------------------------------------------------
@@ -1644,7 +1710,7 @@ void ForNode::printTree(std::string indent, bool last) const
 		body[i]->printTree(indent, i == body.size() - 1);
 }
 
-const ptr_node_t ForNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ForNode::fold(const const_table_t &consts) const
 {
 	std::vector<ptr_node_t> nbody;
 	for (auto &c : body)
@@ -1710,7 +1776,7 @@ void UntilNode::printTree(std::string indent, bool last) const
 		step->printTree(indent, true);
 }
 
-const ptr_node_t UntilNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t UntilNode::fold(const const_table_t &consts) const
 {
 	if (step == nullptr)
 		return std::make_shared<UntilNode>(path, a->fold(consts), b->fold(consts), nullptr, inclusive, token);
@@ -1766,7 +1832,7 @@ void MapNode::printTree(std::string indent, bool last) const
 		args[i].second->printTree(indent, i == args.size() - 1);
 }
 
-const ptr_node_t MapNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t MapNode::fold(const const_table_t &consts) const
 {
 	if (isConst())
 	{
@@ -1774,6 +1840,7 @@ const ptr_node_t MapNode::fold(const std::vector<std::pair<std::vector<hash_ull>
 		object_t newScope(static_cast<hash_ull>(0));
 		trace_t stack_trace;
 		auto r = i->evaluate(&newScope, stack_trace);
+		Node::rewrites++;
 		return std::make_shared<ContainerNode>(path, r, token);
 	}
 
@@ -1868,7 +1935,7 @@ void SwitchNode::printTree(std::string indent, bool last) const
 		elses->printTree(indent, true);
 }
 
-const ptr_node_t SwitchNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t SwitchNode::fold(const const_table_t &consts) const
 {
 	if (isConst())
 	{
@@ -1876,18 +1943,54 @@ const ptr_node_t SwitchNode::fold(const std::vector<std::pair<std::vector<hash_u
 		object_t newScope(static_cast<hash_ull>(0));
 		trace_t stack_trace;
 		auto r = i->evaluate(&newScope, stack_trace);
+		Node::rewrites++;
 		return std::make_shared<ContainerNode>(path, r, token);
 	}
 
 	std::map<ptr_node_t, size_t> ncases;
 	std::vector<ptr_node_t> ngotos;
+	bool constCases = true;
 	for (auto &c : cases)
-		ncases[c.first->fold(consts)] = c.second;
+	{
+		auto nc = c.first->fold(consts);
+		constCases = constCases && nc->isConst();
+		ncases[nc] = c.second;
+	}
 	for (auto &e : gotos)
 		ngotos.push_back(e->fold(consts));
-	auto ret = std::make_shared<SwitchNode>(path, switchs->fold(consts), ncases, ngotos, token);
+	auto nswitchs = switchs->fold(consts);
+	ptr_node_t nelses = nullptr;
 	if (elses)
-		ret->setElse(elses->fold(consts));
+		nelses = elses->fold(consts);
+
+	// With a constant subject and constant labels the taken case is known now
+	if (parser_t::optLevel >= 2 && constCases && nswitchs->isConst())
+	{
+		try
+		{
+			object_t newScope(static_cast<hash_ull>(0));
+			trace_t stack_trace;
+			auto eval = nswitchs->genParser()->evaluate(&newScope, stack_trace);
+			std::map<symbol_t, size_t> solved;
+			for (auto &c : ncases)
+				solved[c.first->genParser()->evaluate(&newScope, stack_trace)] = c.second;
+			ptr_node_t taken = nelses;
+			auto it = solved.find(eval);
+			if (it != solved.end() && it->second > 0)
+				taken = ngotos[it->second - 1];
+			Node::rewrites++;
+			if (taken)
+				return std::make_shared<IfElseNode>(path, std::make_shared<ContainerNode>(path, symbol_t::Boolean(true), token), taken, token);
+			return std::make_shared<ContainerNode>(path, symbol_t(), token);
+		}
+		catch (const rossa_error_t &e)
+		{
+		}
+	}
+
+	auto ret = std::make_shared<SwitchNode>(path, nswitchs, ncases, ngotos, token);
+	if (nelses)
+		ret->setElse(nelses);
 	return ret;
 }
 
@@ -1935,7 +2038,7 @@ void TryCatchNode::printTree(std::string indent, bool last) const
 	catchs->printTree(indent, true);
 }
 
-const ptr_node_t TryCatchNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t TryCatchNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<TryCatchNode>(path, trys->fold(consts), catchs->fold(consts), key, token);
 }
@@ -1978,7 +2081,7 @@ void ThrowNode::printTree(std::string indent, bool last) const
 	throws->printTree(indent, true);
 }
 
-const ptr_node_t ThrowNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t ThrowNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<ThrowNode>(path, throws->fold(consts), token);
 }
@@ -2028,7 +2131,7 @@ void CallOpNode::printTree(std::string indent, bool last) const
 		args[i]->printTree(indent, i == args.size() - 1);
 }
 
-const ptr_node_t CallOpNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t CallOpNode::fold(const const_table_t &consts) const
 {
 	std::vector<ptr_node_t> nargs;
 	for (auto &c : args)
@@ -2086,7 +2189,7 @@ void EachNode::printTree(std::string indent, bool last) const
 		body->printTree(indent, true);
 }
 
-const ptr_node_t EachNode::fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &consts) const
+const ptr_node_t EachNode::fold(const const_table_t &consts) const
 {
 	return std::make_shared<EachNode>(path, id, eachs->fold(consts), wheres ? wheres->fold(consts) : nullptr, body ? body->fold(consts) : nullptr, token);
 }
\ No newline at end of file
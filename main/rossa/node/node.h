@@ -54,6 +54,8 @@ protected:
 	const token_t token;
 
 public:
+	static thread_local size_t rewrites;
+
 	Node(const std::vector<node_scope_t> &, const type_t &, const token_t &);
 	const type_t getType() const;
 	const token_t getToken() const;
@@ -61,7 +63,7 @@ public:
 	virtual ptr_instruction_t genParser() const = 0;
 	virtual bool isConst() const = 0;
 	virtual void printTree(std::string, bool) const = 0;
-	virtual const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const = 0;
+	virtual const ptr_node_t fold(const const_table_t &) const = 0;
 };
 
 class ContainerNode : public Node
@@ -74,7 +76,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class VectorNode : public Node
@@ -88,7 +90,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 	const std::vector<ptr_node_t> &getChildren();
 };
 
@@ -99,7 +101,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class ContinueNode : public Node
@@ -109,7 +111,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class IDNode : public Node
@@ -123,7 +125,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class BIDNode : public Node
@@ -137,7 +139,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class DefineNode : public Node
@@ -154,7 +156,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class VargDefineNode : public Node
@@ -169,7 +171,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class NewNode : public Node
@@ -183,7 +185,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class ClassNode : public Node
@@ -199,7 +201,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class VarNode : public Node
@@ -212,7 +214,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class CallNode : public Node
@@ -228,7 +230,7 @@ public:
 	std::vector<ptr_node_t> getArgs() const;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class ExternCallNode : public Node
@@ -243,7 +245,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class CallBuiltNode : public Node
@@ -258,7 +260,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class ReturnNode : public Node
@@ -271,7 +273,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class ReferNode : public Node
@@ -284,7 +286,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class BinOpNode : public Node
@@ -304,7 +306,7 @@ public:
 	void setB(const ptr_node_t &);
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class UnOpNode : public Node
@@ -318,7 +320,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class ParenNode : public Node
@@ -331,7 +333,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class InsNode : public Node
@@ -347,7 +349,7 @@ public:
 	const ptr_node_t getArg() const;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class IfElseNode : public Node
@@ -363,7 +365,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class WhileNode : public Node
@@ -377,7 +379,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class ForNode : public Node
@@ -392,7 +394,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class UntilNode : public Node
@@ -408,7 +410,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class MapNode : public Node
@@ -421,7 +423,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class SwitchNode : public Node
@@ -438,7 +440,7 @@ public:
 	void setElse(const ptr_node_t &);
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class TryCatchNode : public Node
@@ -453,7 +455,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class ThrowNode : public Node
@@ -466,7 +468,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class CallOpNode : public Node
@@ -480,7 +482,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 class EachNode : public Node
@@ -496,7 +498,7 @@ public:
 	ptr_instruction_t genParser() const override;
 	bool isConst() const override;
 	void printTree(std::string, bool) const override;
-	const ptr_node_t fold(const std::vector<std::pair<std::vector<hash_ull>, symbol_t>> &) const override;
+	const ptr_node_t fold(const const_table_t &) const override;
 };
 
 #endif
\ No newline at end of file
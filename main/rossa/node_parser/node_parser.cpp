@@ -130,6 +130,13 @@ ptr_node_t node_parser_t::parseCallBuiltNode(std::vector<node_scope_t> *scopes)
 		return std::make_shared<IDNode>(*scopes, ROSSA_HASH(temp), marker);
 	nextToken();
 	std::vector<ptr_node_t> args;
+	if (t == TOK_GC)
+	{
+		if (currentToken.type != ')')
+			return logErrorN(util::format(_EXPECTED_ERROR_, {")"}), currentToken);
+		nextToken();
+		return parseTrailingNode(scopes, std::make_shared<CallBuiltNode>(*scopes, t, args, marker), true);
+	}
 	args.push_back(parseEquNode(scopes));
 	if (currentToken.type == ',')
 	{
@@ -834,7 +841,7 @@ ptr_node_t node_parser_t::parseBaseNode(std::vector<node_scope_t> *scopes)
 		{
 			ret = std::make_shared<ContainerNode>(
 				*scopes,
-				symbol_t::String(std::filesystem::absolute(currentToken.filename).string()),
+				symbol_t::String(std::filesystem::absolute(currentToken.getFilename()).string()),
 				currentToken);
 			nextToken();
 			return ret;
@@ -843,7 +850,7 @@ ptr_node_t node_parser_t::parseBaseNode(std::vector<node_scope_t> *scopes)
 		{
 			ret = std::make_shared<ContainerNode>(
 				*scopes,
-				symbol_t::String(std::filesystem::absolute(currentToken.filename.parent_path()).string()),
+				symbol_t::String(std::filesystem::absolute(currentToken.getFilename().parent_path()).string()),
 				currentToken);
 			nextToken();
 			return ret;
@@ -1174,6 +1181,7 @@ ptr_node_t node_parser_t::parseUnitNode(std::vector<node_scope_t> *scopes)
 	case TOK_CHARN:
 	case TOK_CHARS:
 	case TOK_PARSE:
+	case TOK_GC:
 		return parseCallBuiltNode(scopes);
 	case TOK_NEW:
 		return parseNewNode(scopes);
@@ -1619,7 +1627,7 @@ ptr_node_t node_parser_t::parseLoadNode(std::vector<node_scope_t> *scopes)
 
 	auto path = dir::findFile(currentFile.parent_path(), filename, &currentToken);
 
-	if (std::find(dir::loaded.begin(), dir::loaded.end(), path) != dir::loaded.end())
+	if (!dir::markLoaded(path))
 	{
 		if (currentToken.type != ';')
 			return logErrorN(util::format(_EXPECTED_ERROR_, {";"}), currentToken);
@@ -1627,19 +1635,7 @@ ptr_node_t node_parser_t::parseLoadNode(std::vector<node_scope_t> *scopes)
 		return nullptr;
 	}
 
-	dir::loaded.push_back(path);
-
-	std::string content = "";
-	std::string line;
-	std::ifstream myfile(path.string());
-	if (myfile.is_open())
-	{
-		while (getline(myfile, line))
-			content += line + "\n";
-		myfile.close();
-	}
-
-	auto tokens = lexString(content, path.filename().string());
+	auto tokens = dir::getTokens(path);
 	node_parser_t np(tokens, path);
 	auto n = np.parse(scopes, consts);
 
@@ -1738,7 +1734,7 @@ ptr_node_t node_parser_t::parseExprNode(std::vector<node_scope_t> *scopes)
 			{
 				nextToken();
 			}
-			consts->push_back({path, symbol_t::Number(index)});
+			consts->insert_or_assign(path, symbol_t::Number(index));
 			index += number_t::Long(1);
 		}
 		nextToken();
@@ -1769,7 +1765,7 @@ ptr_node_t node_parser_t::parseExprNode(std::vector<node_scope_t> *scopes)
 			for (auto &k : *scopes)
 				path.push_back(k.id);
 			path.push_back(id);
-			consts->push_back({path, vn});
+			consts->insert_or_assign(path, vn);
 			if (currentToken.type != ';')
 				return logErrorN(util::format(_EXPECTED_ERROR_, {";"}), currentToken);
 			nextToken();
@@ -1864,9 +1860,10 @@ ptr_node_t node_parser_t::parseExprNode(std::vector<node_scope_t> *scopes)
 	}
 }
 
-ptr_node_t node_parser_t::parse(std::vector<node_scope_t> *scopes, std::vector<std::pair<std::vector<hash_ull>, symbol_t>> *consts)
+ptr_node_t node_parser_t::parse(std::vector<node_scope_t> *scopes, const_table_t *consts)
 {
 	this->consts = consts;
+	dir::prefetch(tokens, currentFile.parent_path());
 	nextToken();
 	// std::vector<node_scope_t> init = { {ROSSA_HASH("<*>")} };
 	return parseEntryNode(scopes);
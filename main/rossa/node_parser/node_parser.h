@@ -14,7 +14,7 @@ class node_parser_t
 {
 private:
 	hash_ull scope_i = 0;
-	std::vector<std::pair<std::vector<hash_ull>, symbol_t>> *consts;
+	const_table_t *consts;
 
 	const std::vector<token_t> tokens;
 	const std::filesystem::path currentFile;
@@ -67,7 +67,7 @@ private:
 
 public:
 	node_parser_t(const std::vector<token_t> &, const std::filesystem::path &);
-	ptr_node_t parse(std::vector<node_scope_t> *, std::vector<std::pair<std::vector<hash_ull>, symbol_t>> *);
+	ptr_node_t parse(std::vector<node_scope_t> *, const_table_t *);
 	static ptr_instruction_t genParser(const ptr_node_t &);
 };
 
@@ -8,6 +8,9 @@
 #include "../parameter/parameter.h"
 #include "../instruction/instruction.h"
 #include "../parser/parser.h"
+#include "../function/function.h"
+#include "../collector/collector.h"
+#include "../stats/stats.h"
 
 object_t::object_t(scope_t *scope, const object_type_enum &type)
 	: scope{scope}, type{type}
@@ -16,7 +19,7 @@ object_t::object_t(scope_t *scope, const object_type_enum &type)
 	parser_t::object_count++;
 #endif
 	if (type == OBJECT_STRONG)
-		scope->references++;
+		refcount_t::retain(scope->references);
 }
 
 object_t::object_t()
@@ -75,7 +78,7 @@ object_t::object_t(const object_t &s)
 	parser_t::object_count++;
 #endif
 	if (this->scope != NULL)
-		this->scope->references++;
+		refcount_t::retain(this->scope->references);
 }
 
 object_t::~object_t()
@@ -85,26 +88,24 @@ object_t::~object_t()
 #endif
 	if (scope != NULL && type == OBJECT_STRONG)
 	{
-		scope->references--;
-		if (scope->references == 0)
+		if (refcount_t::release(scope->references))
 			delete scope;
 	}
 }
 
 void object_t::operator=(const object_t &b)
 {
+	if (b.scope != NULL && b.type == OBJECT_STRONG)
+		refcount_t::retain(b.scope->references);
+
 	if (this->scope != NULL && type == OBJECT_STRONG)
 	{
-		this->scope->references--;
-		if (this->scope->references == 0)
+		if (refcount_t::release(this->scope->references))
 			delete scope;
 	}
 
 	this->scope = b.scope;
 	this->type = b.type;
-
-	if (this->scope != NULL && this->type == OBJECT_STRONG)
-		this->scope->references++;
 }
 
 const symbol_t object_t::instantiate(const std::vector<symbol_t> &params, const token_t *token, trace_t &stack_trace) const
@@ -114,10 +115,42 @@ const symbol_t object_t::instantiate(const std::vector<symbol_t> &params, const
 
 	object_t o(scope->parent, scope->name_trace, scope->extensions);
 	scope->body->evaluate(&o, stack_trace);
-	o.scope->getVariable(parser_t::HASH_INIT, token, stack_trace).call(params, token, stack_trace);
+	const ptr_function_t init = o.scope->getVariable(parser_t::HASH_INIT, token, stack_trace).getFunction(params, token, stack_trace);
+	if (init->stores == nullptr || !o.storeFields(*init, params, token, stack_trace))
+		function_evaluate(init, params, token, stack_trace);
 	return symbol_t::Object(o);
 }
 
+// Runs an `init` compiled to field stores without opening a frame for it.
+// Declines unless every field is a member of this instance that `=` would copy into plainly, as it would from the frame.
+const bool object_t::storeFields(const function_t &init, const std::vector<symbol_t> &params, const token_t *token, trace_t &stack_trace) const
+{
+	{
+		spin_guard_t guard(scope->valuesLock);
+		for (auto &s : *init.stores)
+		{
+			const auto it = scope->values.find(s.field);
+			if (it == scope->values.end() || it->second.getValueType() == value_type_enum::OBJECT)
+				return false;
+		}
+	}
+
+	stats::countCall(init.key);
+	collector_t::poll();
+	for (auto &s : *init.stores)
+	{
+		const symbol_t &field = scope->getVariable(s.field, token, stack_trace);
+		if (s.constant != nullptr)
+		{
+			const symbol_t value = s.constant->evaluate(this, stack_trace);
+			field.set(&value, token, stack_trace);
+		}
+		else
+			field.set(&params[s.param], token, stack_trace);
+	}
+	return true;
+}
+
 const parameter_t object_t::getTypeVec() const
 {
 	return parameter_t(scope->extensions, scope->name_trace);
@@ -143,6 +176,7 @@ const symbol_t object_t::getThis(const token_t *token, trace_t &stack_trace) con
 
 const bool object_t::hasValue(const hash_ull &key) const
 {
+	spin_guard_t guard(scope->valuesLock);
 	return scope->values.find(key) != scope->values.end();
 }
 
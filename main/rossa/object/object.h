@@ -9,6 +9,8 @@ struct object_t
 private:
 	scope_t *scope;
 
+	const bool storeFields(const function_t &, const std::vector<symbol_t> &, const token_t *, trace_t &) const;
+
 public:
 	object_type_enum type;
 
@@ -65,12 +65,12 @@ const std::string parameter_t::toCodeString() const
 	return s + ")";
 }
 
-const std::vector<parameter_t> parameter_t::getQualifiers() const
+const std::vector<parameter_t> &parameter_t::getQualifiers() const
 {
 	return this->qualifiers;
 }
 
-const aug_type_t parameter_t::getBase() const
+const aug_type_t &parameter_t::getBase() const
 {
 	return this->base;
 }
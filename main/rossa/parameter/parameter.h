@@ -14,8 +14,8 @@ public:
 	parameter_t(const std::vector<aug_type_t> &, const aug_type_t &);
 	parameter_t(const std::vector<aug_type_t> &, const aug_type_t &, const std::vector<parameter_t> &);
 	void addQualifier(const parameter_t &);
-	const std::vector<parameter_t> getQualifiers() const;
-	const aug_type_t getBase() const;
+	const std::vector<parameter_t> &getQualifiers() const;
+	const aug_type_t &getBase() const;
 	const std::string toString() const;
 	const std::string toCodeString() const;
 	const bool operator<(const parameter_t &) const;
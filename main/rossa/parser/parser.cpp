@@ -14,7 +14,12 @@ long long parser_t::symbol_count = 0;
 long long parser_t::object_count = 0;
 #endif
 
+#define MAX_FOLD_PASSES 16
+
 Hash parser_t::MAIN_HASH = Hash();
+int parser_t::optLevel = 1;
+size_t parser_t::maxDepth = 0;
+thread_local bool refcount_t::threaded = false;
 
 const hash_ull parser_t::HASH_INIT = ROSSA_HASH(KEYWORD_INIT);
 const hash_ull parser_t::HASH_BLANK = ROSSA_HASH("");
@@ -51,6 +56,7 @@ const hash_ull parser_t::HASH_LENGTH = ROSSA_HASH("len");
 const hash_ull parser_t::HASH_CCT = ROSSA_HASH("++");
 const hash_ull parser_t::HASH_DEL = ROSSA_HASH("delete");
 const hash_ull parser_t::HASH_HASH = ROSSA_HASH("@");
+const hash_ull parser_t::HASH_TO_STRING = ROSSA_HASH("->" KEYWORD_STRING);
 
 parser_t::parser_t(const std::vector<std::string> &args)
 {
@@ -65,7 +71,7 @@ parser_t::parser_t(const std::vector<std::string> &args)
 		argv.push_back(symbol_t::String(s));
 	}
 	scopes.push_back({ROSSA_HASH("<*>")});
-	consts.push_back({{ROSSA_HASH("<*>"), ROSSA_HASH("__args__")}, symbol_t::Array(argv)});
+	consts.insert({{ROSSA_HASH("<*>"), ROSSA_HASH("__args__")}, symbol_t::Array(argv)});
 }
 
 const ptr_node_t parser_t::compileCode(const std::string &code, const std::filesystem::path &currentFile)
@@ -73,8 +79,20 @@ const ptr_node_t parser_t::compileCode(const std::string &code, const std::files
 	auto tokens = lexString(code, currentFile);
 	node_parser_t testnp(tokens, currentFile);
 	auto n = testnp.parse(&this->scopes, &this->consts);
-	// fold twice (temporary) to refold constants
-	return n->fold(this->consts)->fold(this->consts);
+	return optimize(n);
+}
+
+// -O0 folds once, which is still needed to substitute const bindings.
+// -O1 repeats folding until nothing changes; -O2 also removes dead branches.
+const ptr_node_t parser_t::optimize(ptr_node_t n) const
+{
+	size_t passes = 0;
+	do
+	{
+		Node::rewrites = 0;
+		n = n->fold(this->consts);
+	} while (optLevel > 0 && Node::rewrites > 0 && ++passes < MAX_FOLD_PASSES);
+	return n;
 }
 
 const symbol_t parser_t::runCode(const ptr_node_t &entry, const bool &tree)
@@ -82,7 +100,9 @@ const symbol_t parser_t::runCode(const ptr_node_t &entry, const bool &tree)
 	if (tree)
 	{
 		entry->printTree("", true);
-		for (auto &c : consts)
+		// Hash ids follow declaration order, so sorting by path keeps the listing stable
+		std::map<std::vector<hash_ull>, symbol_t> sorted(consts.begin(), consts.end());
+		for (auto &c : sorted)
 		{
 			int i = 0;
 			for (auto &p : c.first)
@@ -99,10 +119,14 @@ const symbol_t parser_t::runCode(const ptr_node_t &entry, const bool &tree)
 		}
 	}
 
-	auto g = node_parser_t::genParser(entry);
+	return runCode(node_parser_t::genParser(entry));
+}
 
+// Runs an already generated instruction tree, so a host can run the same program repeatedly
+const symbol_t parser_t::runCode(const ptr_instruction_t &entry)
+{
 	trace_t stack_trace;
-	return g->evaluate(&main, stack_trace);
+	return entry->evaluate(&main, stack_trace);
 }
 
 void parser_t::printError(const rossa_error_t &e)
@@ -112,9 +136,9 @@ void parser_t::printError(const rossa_error_t &e)
 
 	if (e.getToken().type != NULL_TOK)
 	{
-		std::string lineInfoRaw = "<" + e.getToken().filename.string() + ">:" + std::to_string(e.getToken().lineNumber + 1) + " | ";
+		std::string lineInfoRaw = "<" + e.getToken().getFilename().string() + ">:" + std::to_string(e.getToken().lineNumber + 1) + " | ";
 		printc(lineInfoRaw, CYAN_TEXT);
-		printc(e.getToken().line + "\n", MAGENTA_TEXT);
+		printc(e.getToken().getLine() + "\n", MAGENTA_TEXT);
 
 		std::string ret = "";
 		for (size_t i = 0; i < e.getToken().distance - e.getToken().valueString.size() + lineInfoRaw.size(); i++)
@@ -135,9 +159,10 @@ void parser_t::printError(const rossa_error_t &e)
 
 	size_t j = 0;
 	auto trace = e.getTrace();
+	const auto &parents = e.getParentKeys();
 	while (!trace.empty())
 	{
-		if (j++ > 10)
+		if (j++ >= STACK_TRACE_SHOWN)
 		{
 			printc(util::format(_STACK_TRACE_MORE_, {std::to_string(trace.size())}), MAGENTA_TEXT);
 			std::cout << "\n";
@@ -147,14 +172,14 @@ void parser_t::printError(const rossa_error_t &e)
 		auto e = trace.back();
 		printc(" ^ ", BLUE_TEXT);
 		std::string ret = "";
-		if (e.second.getParent().getKey() != "")
+		if (parents[j - 1] != "")
 		{
-			ret += e.second.getParent().getKey() + ".";
+			ret += parents[j - 1] + ".";
 		}
-		ret += ROSSA_DEHASH(e.second.key);
+		ret += ROSSA_DEHASH(e.second->key);
 		printc(ret + "(", BRIGHT_BLACK_TEXT);
 		size_t i = 0;
-		for (auto &p : e.second.params)
+		for (auto &p : e.second->params)
 		{
 			if (i++ > 0)
 			{
@@ -166,8 +191,8 @@ void parser_t::printError(const rossa_error_t &e)
 			printc(ROSSA_DEHASH(p.second), RESET_TEXT);
 		}
 		printc(")\n", BRIGHT_BLACK_TEXT);
-		printc("\t<" + e.first.filename.string() + ">:" + std::to_string(e.first.lineNumber) + " | ", CYAN_TEXT);
-		printc(e.first.line + "\n", MAGENTA_TEXT);
+		printc("\t<" + e.first.getFilename().string() + ">:" + std::to_string(e.first.lineNumber) + " | ", CYAN_TEXT);
+		printc(e.first.getLine() + "\n", MAGENTA_TEXT);
 		trace.pop_back();
 	}
 }
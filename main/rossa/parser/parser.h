@@ -11,13 +11,15 @@
 class parser_t
 {
 private:
-	std::vector<std::pair<std::vector<hash_ull>, symbol_t>> consts;
+	const_table_t consts;
 	std::vector<node_scope_t> scopes;
 
 public:
 	object_t main;
 
 	static Hash MAIN_HASH;
+	static int optLevel;
+	static size_t maxDepth;
 
 	static const hash_ull HASH_THIS;
 	static const hash_ull HASH_BLANK;
@@ -54,10 +56,13 @@ public:
 	static const hash_ull HASH_CCT;
 	static const hash_ull HASH_DEL;
 	static const hash_ull HASH_HASH;
+	static const hash_ull HASH_TO_STRING;
 
 	parser_t(const std::vector<std::string> &);
 	const ptr_node_t compileCode(const std::string &, const std::filesystem::path &);
+	const ptr_node_t optimize(ptr_node_t) const;
 	const symbol_t runCode(const ptr_node_t &, const bool &);
+	const symbol_t runCode(const ptr_instruction_t &);
 	static void printError(const rossa_error_t &);
 
 	~parser_t();
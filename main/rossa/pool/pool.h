@@ -0,0 +1,157 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <mutex>
+#include <vector>
+
+/**
+ * Fixed-size block pool
+ * Blocks are carved out of `SLAB`-aligned slabs and recycled through a free
+ * list. Each thread owns its own pool, so allocating and freeing its own
+ * blocks needs no locking. Every slab starts with a pointer to the owner it
+ * was carved for, so a block freed on another thread goes back to that owner
+ * (under the owner's lock) and is reclaimed once the owner runs dry.
+ *
+ * When a thread exits its owner is orphaned: the slabs stay alive until the
+ * last block still held elsewhere is freed, and are then released.
+ *
+ * Building with `-D_NO_POOL_` (`make pool=false`) falls back to the global
+ * `operator new` for comparison.
+ */
+template <size_t SIZE, size_t SLAB = 64 * 1024>
+class pool_t
+{
+private:
+	union block_t
+	{
+		block_t *next;
+		alignas(std::max_align_t) unsigned char data[SIZE];
+	};
+
+	// Shared with every thread that frees blocks of this pool, and outlives the thread once orphaned
+	struct owner_t
+	{
+		std::mutex lock;
+		block_t *remote = NULL;
+		std::vector<void *> slabs;
+		size_t live = 0;
+		bool alive = true;
+	};
+
+	static constexpr size_t FIRST = (sizeof(owner_t *) + alignof(block_t) - 1) / alignof(block_t) * alignof(block_t);
+	static constexpr size_t COUNT = (SLAB - FIRST) / sizeof(block_t);
+	static_assert(COUNT > 1, "slab too small for pool block");
+
+	static inline thread_local pool_t *current = NULL;
+
+	owner_t *owner;
+	block_t *head = NULL;
+	size_t inUse = 0;
+
+	pool_t()
+		: owner{new owner_t()}
+	{
+		current = this;
+	}
+
+	~pool_t()
+	{
+		current = NULL;
+		bool done;
+		{
+			std::lock_guard<std::mutex> guard(owner->lock);
+			for (block_t *b = owner->remote; b != NULL; b = b->next)
+				inUse--;
+			owner->remote = NULL;
+			owner->alive = false;
+			owner->live = inUse;
+			done = inUse == 0;
+		}
+		if (done)
+			release(owner);
+	}
+
+	static inline owner_t *ownerOf(void *p)
+	{
+		return *reinterpret_cast<owner_t **>(reinterpret_cast<uintptr_t>(p) & ~static_cast<uintptr_t>(SLAB - 1));
+	}
+
+	static void release(owner_t *o)
+	{
+		for (void *s : o->slabs)
+			::operator delete(s, std::align_val_t(SLAB));
+		delete o;
+	}
+
+	void grow()
+	{
+		{
+			std::lock_guard<std::mutex> guard(owner->lock);
+			head = owner->remote;
+			owner->remote = NULL;
+		}
+		if (head != NULL)
+		{
+			for (block_t *b = head; b != NULL; b = b->next)
+				inUse--;
+			return;
+		}
+
+		unsigned char *slab = static_cast<unsigned char *>(::operator new(SLAB, std::align_val_t(SLAB)));
+		*reinterpret_cast<owner_t **>(slab) = owner;
+		block_t *blocks = reinterpret_cast<block_t *>(slab + FIRST);
+		for (size_t i = 0; i < COUNT - 1; i++)
+			blocks[i].next = &blocks[i + 1];
+		blocks[COUNT - 1].next = NULL;
+		head = blocks;
+		std::lock_guard<std::mutex> guard(owner->lock);
+		owner->slabs.push_back(slab);
+	}
+
+	static void freeRemote(owner_t *o, block_t *b)
+	{
+		std::unique_lock<std::mutex> guard(o->lock);
+		if (o->alive)
+		{
+			b->next = o->remote;
+			o->remote = b;
+			return;
+		}
+		if (--o->live > 0)
+			return;
+		guard.unlock();
+		release(o);
+	}
+
+public:
+	static inline void *allocate()
+	{
+		thread_local pool_t pool;
+		if (pool.head == NULL)
+			pool.grow();
+		block_t *b = pool.head;
+		pool.head = b->next;
+		pool.inUse++;
+		return b;
+	}
+
+	static inline void deallocate(void *p)
+	{
+		block_t *b = static_cast<block_t *>(p);
+		owner_t *o = ownerOf(p);
+		pool_t *c = current;
+		if (c != NULL && c->owner == o)
+		{
+			b->next = c->head;
+			c->head = b;
+			c->inUse--;
+			return;
+		}
+		freeRemote(o, b);
+	}
+};
+
+#endif
@@ -11,6 +11,10 @@
 #include <iostream>
 #include <filesystem>
 #include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 
 #define _ROSSA_VERSION_ "v1.18.2-alpha"
 
@@ -42,6 +46,8 @@ class Node;
 class node_parser_t;
 class parser_t;
 class value_t;
+class collector_t;
+struct gc_heap_t;
 
 typedef unsigned long long hash_ull;
 typedef unsigned long long refc_ull;
@@ -55,6 +61,20 @@ typedef std::vector<type_sll> aug_type_t;
 
 typedef std::string (*cm_fns_t)();
 
+// Hashes a scope path such as `<*>.Foo.bar`, keying the compile-time constant table
+struct hash_path_t
+{
+	inline size_t operator()(const std::vector<hash_ull> &path) const
+	{
+		size_t h = path.size();
+		for (auto &p : path)
+			h ^= std::hash<hash_ull>()(p) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+		return h;
+	}
+};
+
+typedef std::unordered_map<std::vector<hash_ull>, symbol_t, hash_path_t> const_table_t;
+
 enum value_type_enum
 {
 	NIL = -1,
@@ -143,32 +163,105 @@ inline void printc(const std::string &s, const TextColor &color)
 #endif
 }
 
+// Reference counts of values and scopes; they only pay for atomic read-modify-writes once `threaded` is set by a library that runs Rossa code on other threads
+// The flag is per thread: a library sets it on every thread that shares an interpreter's values, so an isolate that never starts threads of its own keeps cheap counts
+struct refcount_t
+{
+	static thread_local bool threaded;
+
+	static inline void retain(std::atomic<refc_ull> &r)
+	{
+		if (threaded)
+			r.fetch_add(1, std::memory_order_relaxed);
+		else
+			r.store(r.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	// Whether that was the last reference
+	static inline const bool release(std::atomic<refc_ull> &r)
+	{
+		if (threaded)
+			return r.fetch_sub(1, std::memory_order_acq_rel) == 1;
+		const refc_ull n = r.load(std::memory_order_relaxed) - 1;
+		r.store(n, std::memory_order_relaxed);
+		return n == 0;
+	}
+};
+
+// Guards a scope's variable table once `refcount_t::threaded` is set; uncontended it costs a single exchange
+// Only the table is guarded: the values in it are not, so threads must not write a value another thread is using
+class spinlock_t
+{
+private:
+	std::atomic<bool> held{false};
+
+public:
+	inline void lock()
+	{
+		while (held.exchange(true, std::memory_order_acquire))
+			std::this_thread::yield();
+	}
+
+	inline void unlock()
+	{
+		held.store(false, std::memory_order_release);
+	}
+};
+
+class spin_guard_t
+{
+private:
+	spinlock_t *const l;
+
+public:
+	spin_guard_t(spinlock_t &l)
+		: l{refcount_t::threaded ? &l : NULL}
+	{
+		if (this->l != NULL)
+			this->l->lock();
+	}
+
+	~spin_guard_t()
+	{
+		if (l != NULL)
+			l->unlock();
+	}
+};
+
 class Hash
 {
 private:
 	std::vector<std::string> variable_hash;
+	std::unordered_map<std::string, hash_ull> variable_index;
+	mutable std::mutex lock;
 
 public:
 	Hash()
 	{
 		variable_hash.push_back("<LAMBDA>");
+		variable_index["<LAMBDA>"] = 0;
 	}
 
 	inline const hash_ull hashValue(const std::string &key)
 	{
-		if (std::find(variable_hash.begin(), variable_hash.end(), key) != variable_hash.end())
-			return std::distance(variable_hash.begin(), std::find(variable_hash.begin(), variable_hash.end(), key));
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = variable_index.find(key);
+		if (it != variable_index.end())
+			return it->second;
 		variable_hash.push_back(key);
+		variable_index[key] = variable_hash.size() - 1;
 		return variable_hash.size() - 1;
 	}
 
 	inline const std::string deHash(const hash_ull &code) const
 	{
+		std::lock_guard<std::mutex> guard(lock);
 		return variable_hash[code];
 	}
 
 	inline const std::vector<std::string> getHashTable() const
 	{
+		std::lock_guard<std::mutex> guard(lock);
 		return variable_hash;
 	}
 };
@@ -2,10 +2,17 @@
 
 #include "../function/function.h"
 #include "../symbol/symbol.h"
+#include "../stats/stats.h"
 
 rossa_error_t::rossa_error_t(const std::string &error, const token_t &token, const trace_t &stack_trace)
 	: std::runtime_error(error), token{token}, stack_trace{stack_trace}
 {
+	stats::countError();
+	for (size_t i = stack_trace.size(); i > 0 && parentKeys.size() < STACK_TRACE_SHOWN; i--)
+	{
+		const auto &f = stack_trace[i - 1].second;
+		parentKeys.push_back(f != nullptr && f->parent != NULL ? f->getParent().getKey() : "");
+	}
 }
 
 const token_t &rossa_error_t::getToken() const
@@ -16,4 +23,9 @@ const token_t &rossa_error_t::getToken() const
 const trace_t &rossa_error_t::getTrace() const
 {
 	return stack_trace;
+}
+
+const std::vector<std::string> &rossa_error_t::getParentKeys() const
+{
+	return parentKeys;
 }
\ No newline at end of file
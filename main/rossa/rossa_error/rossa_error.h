@@ -6,18 +6,24 @@
 #include "../rossa.h"
 #include "../tokenizer/tokenizer.h"
 
-typedef std::vector<std::pair<token_t, function_t>> trace_t;
+typedef std::vector<std::pair<token_t, ptr_function_t>> trace_t;
+
+// Innermost trace entries printed for an uncaught error
+#define STACK_TRACE_SHOWN 11
 
 class rossa_error_t : public std::runtime_error
 {
 private:
 	const token_t token;
 	const trace_t stack_trace;
+	// Parent scope names of the innermost traced functions, innermost first; their frames are gone by the time the error is printed
+	std::vector<std::string> parentKeys;
 
 public:
 	rossa_error_t(const std::string &, const token_t &, const trace_t &);
 	const token_t &getToken() const;
 	const trace_t &getTrace() const;
+	const std::vector<std::string> &getParentKeys() const;
 };
 
 #endif
\ No newline at end of file
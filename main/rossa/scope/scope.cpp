@@ -2,16 +2,35 @@
 
 #include "../parser/parser.h"
 #include "../util/util.h"
+#include "../stats/stats.h"
+#include "../pool/pool.h"
+#include "../collector/collector.h"
+
+#ifndef _NO_POOL_
+void *scope_t::operator new(size_t size)
+{
+	return pool_t<sizeof(scope_t)>::allocate();
+}
+
+void scope_t::operator delete(void *p)
+{
+	pool_t<sizeof(scope_t)>::deallocate(p);
+}
+#endif
 
 scope_t::scope_t(const scope_type_enum &type, scope_t *parent, const ptr_instruction_t &body, const hash_ull &key)
 	: type{type}, parent{parent}, body{body}
 {
+	stats::countScope();
+	collector_t::track(this);
 	traceName(key);
 }
 
 scope_t::scope_t(scope_t *parent, const aug_type_t &name_trace, const std::vector<aug_type_t> &extensions)
 	: type{scope_type_enum::SCOPE_INSTANCE}, parent{parent}, name_trace{name_trace}, extensions{extensions}
 {
+	stats::countScope();
+	collector_t::track(this);
 }
 
 void scope_t::traceName(const hash_ull &key)
@@ -28,14 +47,14 @@ void scope_t::traceName(const hash_ull &key)
 
 const symbol_t &scope_t::getVariable(const hash_ull &key, const token_t *token, trace_t &stack_trace) const
 {
-	const auto it = values.find(key);
-	if (it != values.end())
+	for (const scope_t *s = this; s != NULL; s = s->parent)
 	{
-		return it->second;
-	}
-	if (parent != NULL)
-	{
-		return parent->getVariable(key, token, stack_trace);
+		spin_guard_t guard(s->valuesLock);
+		const auto it = s->values.find(key);
+		if (it != s->values.end())
+		{
+			return it->second;
+		}
 	}
 
 	throw rossa_error_t(util::format(_UNDECLARED_VARIABLE_ERROR_, {ROSSA_DEHASH(key)}), *token, stack_trace);
@@ -43,12 +62,14 @@ const symbol_t &scope_t::getVariable(const hash_ull &key, const token_t *token,
 
 const symbol_t &scope_t::createVariable(const hash_ull &key, const token_t *token)
 {
+	spin_guard_t guard(valuesLock);
 	values[key].nullify();
 	return values[key];
 }
 
 const symbol_t &scope_t::createVariable(const hash_ull &key, const symbol_t &d, const token_t *token)
 {
+	spin_guard_t guard(valuesLock);
 	const auto it = values.find(key);
 	if (it != values.end() && it->second.getValueType() == value_type_enum::FUNCTION)
 	{
@@ -62,6 +83,7 @@ const unsigned int scope_t::hash() const
 {
 	int h = 0;
 	int i = 0;
+	spin_guard_t guard(valuesLock);
 	for (auto &e : values)
 	{
 		h = (h + ((e.first + e.second.hash()) << i++)) % 0xFFFFFFFF;
@@ -69,6 +91,33 @@ const unsigned int scope_t::hash() const
 	return h;
 }
 
+// Whether this scope, kept alive by whoever asks, neither sits below the frame `scope` nor holds anything that resolves names through it
+const bool scope_t::outlives(const scope_t *scope, size_t &budget) const
+{
+	for (const scope_t *s = parent; s != NULL; s = s->parent)
+	{
+		if (s == scope || s->type == scope_type_enum::SCOPE_INSTANCE)
+			return false;
+	}
+
+	// Copied out first, so a value referring back to this scope does not take its lock again
+	std::vector<symbol_t> held;
+	{
+		spin_guard_t guard(valuesLock);
+		if (values.size() > budget)
+			return false;
+		held.reserve(values.size());
+		for (auto &e : values)
+			held.push_back(e.second);
+	}
+	for (auto &e : held)
+	{
+		if (!e.outlives(scope, budget, this))
+			return false;
+	}
+	return true;
+}
+
 const symbol_t scope_t::getThis(const token_t *token, trace_t &stack_trace)
 {
 	if (type != scope_type_enum::SCOPE_BOUNDED)
@@ -85,6 +134,8 @@ const symbol_t scope_t::getThis(const token_t *token, trace_t &stack_trace)
 
 scope_t::~scope_t()
 {
+	stats::countScopeFree();
+	collector_t::untrack(this);
 #ifdef DEBUG
 	std::cout << "~scope_t\t" << std::to_string(type) << "\n";
 #endif
@@ -105,11 +156,16 @@ scope_t::~scope_t()
 	}
 	for (auto &e : values)
 	{
-		e.second.shift();
+		e.second.shift(this);
 	}
 }
 
 scope_t *scope_t::getParent() const
 {
 	return parent;
+}
+
+const scope_type_enum scope_t::getType() const
+{
+	return type;
 }
\ No newline at end of file
@@ -10,23 +10,36 @@
 class scope_t
 {
 	friend class object_t;
+	friend class collector_t;
+	friend struct function_t;
 
 public:
 	scope_t *getParent() const;
+	const scope_type_enum getType() const;
 	const unsigned int hash() const;
+	const bool outlives(const scope_t *, size_t &) const;
 
 private:
 	const scope_type_enum type;
-	scope_t *const parent;
-	refc_ull references = 1;
+	scope_t *parent;
+	std::atomic<refc_ull> references{1};
 	std::map<const hash_ull, const symbol_t> values;
+	mutable spinlock_t valuesLock;
 	const ptr_instruction_t body;
 	//hash_ull hashed_key;
 	aug_type_t name_trace;
 	std::vector<aug_type_t> extensions;
+	gc_heap_t *gcHeap;
+	scope_t *gcPrev;
+	scope_t *gcNext;
 
 	void traceName(const hash_ull &);
 
+#ifndef _NO_POOL_
+	static void *operator new(size_t);
+	static void operator delete(void *);
+#endif
+
 	scope_t(const scope_type_enum &, scope_t *, const ptr_instruction_t &, const hash_ull &);
 	scope_t(scope_t *, const aug_type_t &, const std::vector<aug_type_t> &);
 
@@ -5,37 +5,44 @@
 #include "../object/object.h"
 #include "../function/function.h"
 #include "../parameter/parameter.h"
+#include "../stats/stats.h"
 
 signature_t::signature_t()
+	: values{std::make_shared<const std::vector<parameter_t>>()}
 {
 }
 
 signature_t::signature_t(const std::vector<parameter_t> &values)
-	: values{values}
+	: values{std::make_shared<const std::vector<parameter_t>>(values)}
 {
 }
 
 const size_t signature_t::validity(const std::vector<symbol_t> &check, trace_t &stack_trace) const
 {
-	if (values.size() == 0)
+	stats::countValidity();
+	if (values->size() == 0)
 	{
 		return 1;
 	}
 
 	size_t v = 0;
-	for (size_t i = 0; i < values.size(); i++)
+	for (size_t i = 0; i < values->size(); i++)
 	{
-		auto check_i = check[i];
-		auto values_i = values[i];
-		auto vt = check_i.getAugValueType();
+		const symbol_t &check_i = check[i];
+		const parameter_t &values_i = (*values)[i];
 		if (values_i.getQualifiers().empty())
 		{
-			auto base = values_i.getBase();
-			if (base == vt.getBase())
+			const auto &base = values_i.getBase();
+			const auto type = check_i.getValueType();
+			// Only objects carry an augmented type; everything else is just its value type
+			const bool exact = type == value_type_enum::OBJECT
+								   ? base == check_i.getAugValueType().getBase()
+								   : base.size() == 1 && base[0] == type;
+			if (exact)
 			{
 				v += 3;
 			}
-			else if (base[0] > 0 && vt.getBase()[0] == value_type_enum::NIL)
+			else if (base[0] > 0 && type == value_type_enum::NIL)
 			{
 				v += 2;
 			}
@@ -61,8 +68,8 @@ const size_t signature_t::validity(const std::vector<symbol_t> &check, trace_t &
 		}
 		else
 		{
-			auto ql = values_i.getQualifiers();
-			auto fo = check_i.getFunctionOverloads(NULL, stack_trace);
+			const auto &ql = values_i.getQualifiers();
+			const auto &fo = check_i.getFunctionOverloads(NULL, stack_trace);
 			const auto it = fo.find(ql.size());
 			if (it == fo.end())
 			{
@@ -78,11 +85,11 @@ const size_t signature_t::validity(const std::vector<symbol_t> &check, trace_t &
 			else
 			{
 				size_t flag = 0;
-				for (auto f : it->second)
+				for (auto &f : it->second)
 				{
 					for (size_t i = 0; i < ql.size(); i++)
 					{
-						auto val = ql[i] & f.first.values[i];
+						auto val = ql[i] & (*f.first.values)[i];
 						if (val > flag)
 						{
 							flag = val;
@@ -122,7 +129,7 @@ const std::string signature_t::toCodeString() const
 {
 	std::string s = "{";
 	size_t i = 0;
-	for (auto &v : values)
+	for (auto &v : *values)
 	{
 		if (i++ > 0)
 		{
@@ -137,7 +144,7 @@ const std::string signature_t::toString() const
 {
 	std::string s = "";
 	size_t i = 0;
-	for (auto &v : values)
+	for (auto &v : *values)
 	{
 		if (i++ > 0)
 		{
@@ -150,10 +157,10 @@ const std::string signature_t::toString() const
 
 const bool signature_t::operator<(const signature_t &s) const
 {
-	return values < s.values;
+	return values != s.values && *values < *s.values;
 }
 
 const bool signature_t::operator==(const signature_t &s) const
 {
-	return values == s.values;
+	return values == s.values || *values == *s.values;
 }
\ No newline at end of file
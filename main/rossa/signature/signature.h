@@ -8,7 +8,8 @@
 struct signature_t
 {
 private:
-	const std::vector<parameter_t> values;
+	// Shared between copies, since every function value and overload table holds its own signature
+	std::shared_ptr<const std::vector<parameter_t>> values;
 
 public:
 	signature_t();
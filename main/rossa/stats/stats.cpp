@@ -0,0 +1,200 @@
+#include "stats.h"
+
+#include "../parser/parser.h"
+#include "../instruction/instruction.h"
+
+#include <cstdlib>
+#include <iomanip>
+
+namespace stats
+{
+	bool enabled = false;
+	bool json = false;
+
+	std::atomic<refc_ull> instructions[COLLECT_I + 1];
+	std::atomic<refc_ull> symbolAllocs{0};
+	std::atomic<refc_ull> symbolFrees{0};
+	std::atomic<refc_ull> valueAllocs{0};
+	std::atomic<refc_ull> valueFrees{0};
+	std::atomic<refc_ull> scopeAllocs{0};
+	std::atomic<refc_ull> scopeFrees{0};
+	std::atomic<refc_ull> validityChecks{0};
+	std::atomic<refc_ull> errors{0};
+	std::map<hash_ull, refc_ull> calls;
+	std::mutex callsLock;
+
+	static const char *INSTRUCTION_NAMES[] = {
+		"CONTAINER",
+		"VARIABLE",
+		"SEQUENCE",
+		"DECLARE",
+		"INDEX",
+		"INNER",
+		"IF_THEN_ELSE",
+		"IF_THEN",
+		"WHILE",
+		"DEFINE",
+		"VARG_DEFINE",
+		"RETURN",
+		"EXTERN",
+		"LENGTH",
+		"CLASS_I",
+		"NEW_I",
+		"CAST_TO_I",
+		"POW_I",
+		"ALLOC_I",
+		"UNTIL_STEP_EXC_I",
+		"UNTIL_NO_STEP_EXC_I",
+		"UNTIL_STEP_INC_I",
+		"UNTIL_NO_STEP_INC_I",
+		"SCOPE_I",
+		"REFER_I",
+		"MAP_I",
+		"SWITCH_I",
+		"TRY_CATCH_I",
+		"THROW_I",
+		"CHARS_I",
+		"CHARN_I",
+		"FOR",
+		"SET",
+		"ADD",
+		"SUB",
+		"MUL",
+		"DIV",
+		"MOD",
+		"LESS",
+		"MORE",
+		"ELESS",
+		"EMORE",
+		"EQUALS",
+		"NEQUALS",
+		"PURE_EQUALS",
+		"PURE_NEQUALS",
+		"AND",
+		"OR",
+		"B_AND",
+		"B_OR",
+		"B_XOR",
+		"B_SH_L",
+		"B_SH_R",
+		"DECLARE_VARS_I",
+		"B_NOT_I",
+		"TYPE_I",
+		"CALL_OP_I",
+		"GET_THIS_I",
+		"DELETE_I",
+		"UN_ADD_I",
+		"NEG_I",
+		"NOT_I",
+		"CONCAT_I",
+		"SET_INDEX_I",
+		"HASH_I",
+		"EACH_I",
+		"FDIV_I",
+		"CALL_I",
+		"CALL_INNER_I",
+		"COLLECT_I"};
+
+	static_assert(sizeof(INSTRUCTION_NAMES) / sizeof(INSTRUCTION_NAMES[0]) == COLLECT_I + 1, "INSTRUCTION_NAMES must match instruction_type_enum");
+
+	static void printAtExit()
+	{
+		if (json)
+			printJSON(std::cerr);
+		else
+			print(std::cerr);
+	}
+
+	static const std::vector<std::pair<std::string, refc_ull>> sortedCalls()
+	{
+		std::vector<std::pair<std::string, refc_ull>> ret;
+		std::lock_guard<std::mutex> guard(callsLock);
+		for (auto &e : calls)
+			ret.push_back({ROSSA_DEHASH(e.first), e.second});
+		std::stable_sort(ret.begin(), ret.end(), [](const std::pair<std::string, refc_ull> &a, const std::pair<std::string, refc_ull> &b) {
+			return a.second > b.second;
+		});
+		return ret;
+	}
+
+	static const std::string escapeJSON(const std::string &s)
+	{
+		std::string ret;
+		for (auto &c : s)
+		{
+			if (c == '"' || c == '\\')
+				ret += '\\';
+			ret += c;
+		}
+		return ret;
+	}
+
+	void enable(const bool &asJSON)
+	{
+		if (!enabled)
+			std::atexit(printAtExit);
+		enabled = true;
+		json = asJSON;
+	}
+
+	void print(std::ostream &out)
+	{
+		refc_ull total = 0;
+		std::vector<std::pair<std::string, refc_ull>> ins;
+		for (size_t i = 0; i <= COLLECT_I; i++)
+		{
+			const refc_ull n = instructions[i].load(std::memory_order_relaxed);
+			total += n;
+			if (n > 0)
+				ins.push_back({INSTRUCTION_NAMES[i], n});
+		}
+		std::stable_sort(ins.begin(), ins.end(), [](const std::pair<std::string, refc_ull> &a, const std::pair<std::string, refc_ull> &b) {
+			return a.second > b.second;
+		});
+
+		out << "--- Runtime Statistics ---\n";
+		out << "Symbols:\t" << symbolAllocs << " allocated, " << symbolFrees << " freed\n";
+		out << "Values:\t\t" << valueAllocs << " allocated, " << valueFrees << " freed\n";
+		out << "Scopes:\t\t" << scopeAllocs << " allocated, " << scopeFrees << " freed\n";
+		out << "Validity:\t" << validityChecks << " signature checks\n";
+		out << "Errors:\t\t" << errors << " thrown\n";
+		out << "Instructions:\t" << total << " executed\n";
+		for (auto &e : ins)
+			out << "\t" << std::left << std::setw(24) << e.first << e.second << "\n";
+		auto fns = sortedCalls();
+		out << "Calls:\t\t" << fns.size() << " functions\n";
+		for (auto &e : fns)
+			out << "\t" << std::left << std::setw(24) << e.first << e.second << "\n";
+	}
+
+	void printJSON(std::ostream &out)
+	{
+		out << "{\"symbols\":{\"allocated\":" << symbolAllocs << ",\"freed\":" << symbolFrees << "}";
+		out << ",\"values\":{\"allocated\":" << valueAllocs << ",\"freed\":" << valueFrees << "}";
+		out << ",\"scopes\":{\"allocated\":" << scopeAllocs << ",\"freed\":" << scopeFrees << "}";
+		out << ",\"validity\":" << validityChecks;
+		out << ",\"errors\":" << errors;
+		out << ",\"instructions\":{";
+		bool first = true;
+		for (size_t i = 0; i <= COLLECT_I; i++)
+		{
+			const refc_ull n = instructions[i].load(std::memory_order_relaxed);
+			if (n == 0)
+				continue;
+			if (!first)
+				out << ",";
+			first = false;
+			out << "\"" << INSTRUCTION_NAMES[i] << "\":" << n;
+		}
+		out << "},\"calls\":{";
+		first = true;
+		for (auto &e : sortedCalls())
+		{
+			if (!first)
+				out << ",";
+			first = false;
+			out << "\"" << escapeJSON(e.first) << "\":" << e.second;
+		}
+		out << "}}\n";
+	}
+}
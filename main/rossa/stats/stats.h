@@ -0,0 +1,100 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "../rossa.h"
+
+#include <mutex>
+#include <atomic>
+
+/**
+ * Runtime statistics (`--stats`)
+ * Every hook is a single branch on `stats::enabled`, so the counters cost
+ * next to nothing unless the interpreter is started with `--stats`. The
+ * counters are relaxed atomics, since pool workers and isolates count too.
+ */
+namespace stats
+{
+	extern bool enabled;
+	extern bool json;
+
+	extern std::atomic<refc_ull> instructions[];
+	extern std::atomic<refc_ull> symbolAllocs;
+	extern std::atomic<refc_ull> symbolFrees;
+	extern std::atomic<refc_ull> valueAllocs;
+	extern std::atomic<refc_ull> valueFrees;
+	extern std::atomic<refc_ull> scopeAllocs;
+	extern std::atomic<refc_ull> scopeFrees;
+	extern std::atomic<refc_ull> validityChecks;
+	extern std::atomic<refc_ull> errors;
+	extern std::map<hash_ull, refc_ull> calls;
+	extern std::mutex callsLock;
+
+	void enable(const bool &);
+	void print(std::ostream &);
+	void printJSON(std::ostream &);
+
+	inline void countInstruction(const size_t &type)
+	{
+		if (enabled)
+			instructions[type].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countSymbol()
+	{
+		if (enabled)
+			symbolAllocs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countSymbolFree()
+	{
+		if (enabled)
+			symbolFrees.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countValue()
+	{
+		if (enabled)
+			valueAllocs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countValueFree()
+	{
+		if (enabled)
+			valueFrees.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countScope()
+	{
+		if (enabled)
+			scopeAllocs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countScopeFree()
+	{
+		if (enabled)
+			scopeFrees.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countValidity()
+	{
+		if (enabled)
+			validityChecks.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countError()
+	{
+		if (enabled)
+			errors.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void countCall(const hash_ull &key)
+	{
+		if (enabled)
+		{
+			std::lock_guard<std::mutex> guard(callsLock);
+			calls[key]++;
+		}
+	}
+}
+
+#endif
@@ -4,9 +4,11 @@
 #include "../rossa_error/rossa_error.h"
 #include "../parser/parser.h"
 #include "../function/function.h"
+#include "../scope/scope.h"
 #include "../wrapper/wrapper.h"
 #include "../signature/signature.h"
 #include "../util/util.h"
+#include "../stats/stats.h"
 
 symbol_t::symbol_t()
 	: d{new value_t()}, type{ID_CASUAL}
@@ -14,6 +16,8 @@ symbol_t::symbol_t()
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const type_t &type)
@@ -22,6 +26,8 @@ symbol_t::symbol_t(const type_t &type)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const std::shared_ptr<void> &valuePointer)
@@ -30,6 +36,8 @@ symbol_t::symbol_t(const std::shared_ptr<void> &valuePointer)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const parameter_t &valueType)
@@ -38,6 +46,8 @@ symbol_t::symbol_t(const parameter_t &valueType)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const number_t &valueNumber)
@@ -46,6 +56,8 @@ symbol_t::symbol_t(const number_t &valueNumber)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const bool &valueBool)
@@ -54,6 +66,8 @@ symbol_t::symbol_t(const bool &valueBool)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const std::vector<symbol_t> &valueVector)
@@ -62,6 +76,8 @@ symbol_t::symbol_t(const std::vector<symbol_t> &valueVector)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const object_t &valueObject)
@@ -70,6 +86,8 @@ symbol_t::symbol_t(const object_t &valueObject)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const signature_t &ftype, const ptr_function_t &valueFunction)
@@ -78,6 +96,8 @@ symbol_t::symbol_t(const signature_t &ftype, const ptr_function_t &valueFunction
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const ptr_function_t &valueFunction)
@@ -86,6 +106,8 @@ symbol_t::symbol_t(const ptr_function_t &valueFunction)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const std::string &valueString)
@@ -94,14 +116,18 @@ symbol_t::symbol_t(const std::string &valueString)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 symbol_t::symbol_t(const std::map<const std::string, const symbol_t> &valueDictionary)
 	: d{new value_t(valueDictionary)}, type{ID_CASUAL}
 {
 #ifdef DEBUG
-	parser_t::symbol_count--;
+	parser_t::symbol_count++;
 #endif
+	stats::countSymbol();
+	stats::countValue();
 }
 
 const symbol_t symbol_t::Pointer(const std::shared_ptr<void> &v)
@@ -160,7 +186,8 @@ symbol_t::symbol_t(const symbol_t &s)
 #ifdef DEBUG
 	parser_t::symbol_count++;
 #endif
-	this->d->references++;
+	stats::countSymbol();
+	refcount_t::retain(this->d->references);
 }
 
 symbol_t::~symbol_t()
@@ -168,20 +195,25 @@ symbol_t::~symbol_t()
 #ifdef DEBUG
 	parser_t::symbol_count--;
 #endif
-	d->references--;
-	if (d->references == 0)
+	stats::countSymbolFree();
+	if (refcount_t::release(d->references))
+	{
+		stats::countValueFree();
 		delete d;
+	}
 }
 
 void symbol_t::operator=(const symbol_t &b)
 {
-	this->d->references--;
-	if (this->d->references == 0)
+	refcount_t::retain(b.d->references);
+	if (refcount_t::release(this->d->references))
+	{
+		stats::countValueFree();
 		delete d;
+	}
 
 	this->d = b.d;
 	this->type = b.type;
-	this->d->references++;
 }
 
 const unsigned int symbol_t::hash() const
@@ -293,6 +325,11 @@ const value_type_enum symbol_t::getValueType() const
 	return d->type;
 }
 
+const bool symbol_t::isUnique() const
+{
+	return d->references == 1;
+}
+
 const parameter_t symbol_t::getAugValueType() const
 {
 	if (d->type == value_type_enum::OBJECT)
@@ -339,19 +376,36 @@ const bool symbol_t::hasVarg(const token_t *token, trace_t &stack_trace) const
 
 const ptr_function_t symbol_t::getFunction(const std::vector<symbol_t> &params, const token_t *token, trace_t &stack_trace) const
 {
+	const ptr_function_t f = tryGetFunction(params, stack_trace);
+	if (f != nullptr)
+	{
+		return f;
+	}
+
 	if (d->type != value_type_enum::FUNCTION)
 	{
 		throw rossa_error_t(_NOT_FUNCTION_, *token, stack_trace);
 	}
+	if (std::get<wrapper_t>(d->value).map.find(params.size()) == std::get<wrapper_t>(d->value).map.end())
+	{
+		throw rossa_error_t(_FUNCTION_ARG_SIZE_FAILURE_, *token, stack_trace);
+	}
+	throw rossa_error_t(_FUNCTION_VALUE_NOT_EXIST_, *token, stack_trace);
+}
+
+// Resolved on every call rather than cached per call site: bindings and overload tables change at runtime,
+// and instruction trees are shared between worker threads, so a cache would need its own guard and lock
+const ptr_function_t symbol_t::tryGetFunction(const std::vector<symbol_t> &params, trace_t &stack_trace) const
+{
+	if (d->type != value_type_enum::FUNCTION)
+	{
+		return nullptr;
+	}
 
 	const auto it = std::get<wrapper_t>(d->value).map.find(params.size());
 	if (it == std::get<wrapper_t>(d->value).map.end())
 	{
-		if (std::get<wrapper_t>(d->value).varg != nullptr)
-		{
-			return std::get<wrapper_t>(d->value).varg;
-		}
-		throw rossa_error_t(_FUNCTION_ARG_SIZE_FAILURE_, *token, stack_trace);
+		return std::get<wrapper_t>(d->value).varg;
 	}
 
 	ptr_function_t f = nullptr;
@@ -372,11 +426,7 @@ const ptr_function_t symbol_t::getFunction(const std::vector<symbol_t> &params,
 
 	if (f == nullptr)
 	{
-		if (std::get<wrapper_t>(d->value).varg != nullptr)
-		{
-			return std::get<wrapper_t>(d->value).varg;
-		}
-		throw rossa_error_t(_FUNCTION_VALUE_NOT_EXIST_, *token, stack_trace);
+		return std::get<wrapper_t>(d->value).varg;
 	}
 
 	return f;
@@ -439,9 +489,9 @@ const std::string symbol_t::toString(const token_t *token, trace_t &stack_trace)
 	}
 	case value_type_enum::OBJECT:
 	{
-		if (std::get<object_t>(d->value).hasValue(ROSSA_HASH("->String")))
+		if (std::get<object_t>(d->value).hasValue(parser_t::HASH_TO_STRING))
 		{
-			return std::get<object_t>(d->value).getVariable(ROSSA_HASH("->String"), token, stack_trace).call({}, token, stack_trace).getString(token, stack_trace);
+			return std::get<object_t>(d->value).getVariable(parser_t::HASH_TO_STRING, token, stack_trace).call({}, token, stack_trace).getString(token, stack_trace);
 		}
 		std::stringstream ss;
 		ss << "Object<" << std::get<object_t>(d->value).getKey() << ">";
@@ -602,16 +652,7 @@ void symbol_t::set(const symbol_t *b, const token_t *token, trace_t &stack_trace
 	}
 	if (d->type == value_type_enum::OBJECT && std::get<object_t>(d->value).hasValue(parser_t::HASH_SET))
 	{
-		ptr_function_t f = nullptr;
-		try
-		{
-			f = std::get<object_t>(d->value)
-					.getVariable(parser_t::HASH_SET, token, stack_trace)
-					.getFunction({*b}, token, stack_trace);
-		}
-		catch (const rossa_error_t &e)
-		{
-		}
+		const ptr_function_t f = std::get<object_t>(d->value).getVariable(parser_t::HASH_SET, token, stack_trace).tryGetFunction({*b}, stack_trace);
 		if (f)
 		{
 			function_evaluate(f, {*b}, token, stack_trace);
@@ -770,7 +811,7 @@ const bool symbol_t::operator<(const symbol_t &b) const
 	return this->toCodeString() < b.toCodeString();
 }
 
-void symbol_t::shift() const
+void symbol_t::shift(const scope_t *scope) const
 {
 	if (d->type != value_type_enum::FUNCTION)
 	{
@@ -780,12 +821,58 @@ void symbol_t::shift() const
 	{
 		for (auto &f : e.second)
 		{
-			f.second->shift();
+			f.second->shift(scope);
 		}
 	}
 	if (std::get<wrapper_t>(d->value).varg != nullptr)
 	{
-		std::get<wrapper_t>(d->value).varg->shift();
+		std::get<wrapper_t>(d->value).varg->shift(scope);
+	}
+}
+
+// Whether nothing reachable from this value, within `budget` values, resolves names through the frame `scope`;
+// running out of budget counts as reaching it
+const bool symbol_t::outlives(const scope_t *scope, size_t &budget, const scope_t *held) const
+{
+	if (budget == 0)
+		return false;
+	budget--;
+	switch (d->type)
+	{
+	case value_type_enum::ARRAY:
+		for (auto &e : std::get<std::vector<symbol_t>>(d->value))
+		{
+			if (!e.outlives(scope, budget, held))
+				return false;
+		}
+		return true;
+	case value_type_enum::DICTIONARY:
+		for (auto &e : std::get<std::map<const std::string, const symbol_t>>(d->value))
+		{
+			if (!e.second.outlives(scope, budget, held))
+				return false;
+		}
+		return true;
+	case value_type_enum::OBJECT:
+	{
+		const scope_t *o = std::get<object_t>(d->value).getPtr();
+		return o == NULL || o == held || o->outlives(scope, budget);
+	}
+	case value_type_enum::FUNCTION:
+	{
+		const wrapper_t &w = std::get<wrapper_t>(d->value);
+		for (auto &e : w.map)
+		{
+			for (auto &f : e.second)
+			{
+				if (!f.second->outlives(scope, held))
+					return false;
+			}
+		}
+		return w.varg == nullptr || w.varg->outlives(scope, held);
+	}
+	default:
+		return true;
 	}
 }
 
@@ -6,6 +6,8 @@
 
 struct symbol_t
 {
+	friend class collector_t;
+
 private:
 	value_t *d;
 
@@ -57,6 +59,7 @@ public:
 	const std::shared_ptr<void> getPointer(const token_t *, trace_t &) const;
 	const bool hasVarg(const token_t *, trace_t &) const;
 	const value_type_enum getValueType() const;
+	const bool isUnique() const;
 	const parameter_t getAugValueType() const;
 	const std::string toString(const token_t *, trace_t &) const;
 	const std::string toCodeString() const;
@@ -72,7 +75,8 @@ public:
 	const bool operator!=(const symbol_t &) const;
 	const bool operator<(const symbol_t &) const;
 	const std::map<const size_t, std::map<const signature_t, ptr_function_t>> &getFunctionOverloads(const token_t *, trace_t &) const;
-	void shift() const;
+	void shift(const scope_t *) const;
+	const bool outlives(const scope_t *, size_t &, const scope_t * = NULL) const;
 
 	const symbol_t clone() const;
 
@@ -81,6 +85,7 @@ public:
 	const symbol_t &indexDict(const std::string &) const;
 	const bool hasDictionaryKey(const std::string &) const;
 	const ptr_function_t getFunction(const std::vector<symbol_t> &, const token_t *, trace_t &) const;
+	const ptr_function_t tryGetFunction(const std::vector<symbol_t> &, trace_t &) const;
 	const ptr_function_t &getVARGFunction(const token_t *, trace_t &) const;
 	const parameter_t getTypeName(const token_t *, trace_t &) const;
 	object_t *getObject(const token_t *, trace_t &) const;
@@ -1,7 +1,65 @@
 #include "tokenizer.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 #include "../Keywords.h"
 
+const std::unordered_map<std::string, int> KEYWORD_TOKENS = {
+	{KEYWORD_THEN, TOK_THEN},
+	{KEYWORD_ELSE, TOK_ELSE},
+	{KEYWORD_DO, TOK_DO},
+	{KEYWORD_IN, TOK_IN},
+	{KEYWORD_OF, TOK_OF},
+	{KEYWORD_VAR, TOK_VAR},
+	{KEYWORD_IF, TOK_IF},
+	{KEYWORD_WHILE, TOK_WHILE},
+	{KEYWORD_ELIF, TOK_ELSEIF},
+	{KEYWORD_FOR, TOK_FOR},
+	{KEYWORD_TRUE, TOK_TRUE},
+	{KEYWORD_FALSE, TOK_FALSE},
+	{KEYWORD_RETURN, TOK_RETURN},
+	{KEYWORD_NIL, TOK_NIL},
+	{KEYWORD_NUMBER, TOK_NUMBER},
+	{KEYWORD_STRING, TOK_STRING},
+	{KEYWORD_ARRAY, TOK_ARRAY},
+	{KEYWORD_BOOLEAN, TOK_BOOLEAN},
+	{KEYWORD_DICTIONARY, TOK_DICTIONARY},
+	{KEYWORD_OBJECT, TOK_OBJECT},
+	{KEYWORD_FUNCTION, TOK_FUNCTION},
+	{KEYWORD_TYPE, TOK_TYPE_NAME},
+	{KEYWORD_EXTERN, TOK_EXTERN},
+	{KEYWORD_EXTERN_CALL, TOK_EXTERN_CALL},
+	{KEYWORD_LENGTH, TOK_LENGTH},
+	{KEYWORD_STRUCT, TOK_STRUCT},
+	{KEYWORD_STATIC, TOK_STATIC},
+	{KEYWORD_ENUM, TOK_ENUM},
+	{KEYWORD_NEW, TOK_NEW},
+	{KEYWORD_LOAD, TOK_LOAD},
+	{KEYWORD_ALLOC, TOK_ALLOC},
+	{KEYWORD_REF, TOK_REF},
+	{KEYWORD_BREAK, TOK_BREAK},
+	{KEYWORD_REFER, TOK_REFER},
+	{KEYWORD_NIL_NAME, TOK_NIL_NAME},
+	{KEYWORD_POINTER, TOK_POINTER},
+	{KEYWORD_VIRTUAL, TOK_VIRTUAL},
+	{KEYWORD_SWITCH, TOK_SWITCH},
+	{KEYWORD_TRY, TOK_TRY},
+	{KEYWORD_CATCH, TOK_CATCH},
+	{KEYWORD_THROW, TOK_THROW},
+	{KEYWORD_CHAR_N, TOK_CHARN},
+	{KEYWORD_CHAR_S, TOK_CHARS},
+	{KEYWORD_CASE, TOK_CASE},
+	{KEYWORD_PARSE, TOK_PARSE},
+	{KEYWORD_GC, TOK_GC},
+	{KEYWORD_CONTINUE, TOK_CONTINUE},
+	{KEYWORD_CALL_OP, TOK_CALL_OP},
+	{KEYWORD_ANY, TOK_ANY},
+	{KEYWORD_CONST, TOK_CONST},
+	{KEYWORD_EACH, TOK_EACH},
+	{KEYWORD_WHERE, TOK_WHERE},
+	{KEYWORD_DEF, TOK_DEF}};
+
 const char peekChar(
 	const size_t &i,
 	const std::string &INPUT,
@@ -40,124 +98,21 @@ const int getToken(
 	size_t &TOKEN_DIST,
 	std::string &ID_STRING)
 {
-	static int last;
+	int last;
 	while (isspace(last = nextChar(INPUT, INPUT_INDEX, LINE_INDEX, TOKEN_DIST)))
 		;
 
 	if (isalpha(last) || last == '_')
 	{
-		ID_STRING = last;
+		const size_t start = INPUT_INDEX - 1;
 		while (isalnum(peekChar(0, INPUT, INPUT_INDEX)) || peekChar(0, INPUT, INPUT_INDEX) == '_')
-		{
-			last = nextChar(INPUT, INPUT_INDEX, LINE_INDEX, TOKEN_DIST);
-			ID_STRING += last;
-		}
+			nextChar(INPUT, INPUT_INDEX, LINE_INDEX, TOKEN_DIST);
+		ID_STRING.assign(INPUT, start, INPUT_INDEX - start);
 
-		if (ID_STRING == KEYWORD_THEN)
-			return TOK_THEN;
-		else if (ID_STRING == KEYWORD_ELSE)
-			return TOK_ELSE;
-		else if (ID_STRING == KEYWORD_DO)
-			return TOK_DO;
-		else if (ID_STRING == KEYWORD_IN)
-			return TOK_IN;
-		else if (ID_STRING == KEYWORD_OF)
-			return TOK_OF;
-		else if (ID_STRING == KEYWORD_VAR)
-			return TOK_VAR;
-		else if (ID_STRING == KEYWORD_IF)
-			return TOK_IF;
-		else if (ID_STRING == KEYWORD_WHILE)
-			return TOK_WHILE;
-		else if (ID_STRING == KEYWORD_ELIF)
-			return TOK_ELSEIF;
-		else if (ID_STRING == KEYWORD_FOR)
-			return TOK_FOR;
-		else if (ID_STRING == KEYWORD_TRUE)
-			return TOK_TRUE;
-		else if (ID_STRING == KEYWORD_FALSE)
-			return TOK_FALSE;
-		else if (ID_STRING == KEYWORD_RETURN)
-			return TOK_RETURN;
-		else if (ID_STRING == KEYWORD_NIL)
-			return TOK_NIL;
-		else if (ID_STRING == KEYWORD_NUMBER)
-			return TOK_NUMBER;
-		else if (ID_STRING == KEYWORD_STRING)
-			return TOK_STRING;
-		else if (ID_STRING == KEYWORD_ARRAY)
-			return TOK_ARRAY;
-		else if (ID_STRING == KEYWORD_BOOLEAN)
-			return TOK_BOOLEAN;
-		else if (ID_STRING == KEYWORD_DICTIONARY)
-			return TOK_DICTIONARY;
-		else if (ID_STRING == KEYWORD_OBJECT)
-			return TOK_OBJECT;
-		else if (ID_STRING == KEYWORD_FUNCTION)
-			return TOK_FUNCTION;
-		else if (ID_STRING == KEYWORD_TYPE)
-			return TOK_TYPE_NAME;
-		else if (ID_STRING == KEYWORD_EXTERN)
-			return TOK_EXTERN;
-		else if (ID_STRING == KEYWORD_EXTERN_CALL)
-			return TOK_EXTERN_CALL;
-		else if (ID_STRING == KEYWORD_LENGTH)
-			return TOK_LENGTH;
-		else if (ID_STRING == KEYWORD_STRUCT)
-			return TOK_STRUCT;
-		else if (ID_STRING == KEYWORD_STATIC)
-			return TOK_STATIC;
-		else if (ID_STRING == KEYWORD_ENUM)
-			return TOK_ENUM;
-		else if (ID_STRING == KEYWORD_NEW)
-			return TOK_NEW;
-		else if (ID_STRING == KEYWORD_LOAD)
-			return TOK_LOAD;
-		else if (ID_STRING == KEYWORD_ALLOC)
-			return TOK_ALLOC;
-		else if (ID_STRING == KEYWORD_REF)
-			return TOK_REF;
-		else if (ID_STRING == KEYWORD_BREAK)
-			return TOK_BREAK;
-		else if (ID_STRING == KEYWORD_REFER)
-			return TOK_REFER;
-		else if (ID_STRING == KEYWORD_NIL_NAME)
-			return TOK_NIL_NAME;
-		else if (ID_STRING == KEYWORD_POINTER)
-			return TOK_POINTER;
-		else if (ID_STRING == KEYWORD_VIRTUAL)
-			return TOK_VIRTUAL;
-		else if (ID_STRING == KEYWORD_SWITCH)
-			return TOK_SWITCH;
-		else if (ID_STRING == KEYWORD_TRY)
-			return TOK_TRY;
-		else if (ID_STRING == KEYWORD_CATCH)
-			return TOK_CATCH;
-		else if (ID_STRING == KEYWORD_THROW)
-			return TOK_THROW;
-		else if (ID_STRING == KEYWORD_CHAR_N)
-			return TOK_CHARN;
-		else if (ID_STRING == KEYWORD_CHAR_S)
-			return TOK_CHARS;
-		else if (ID_STRING == KEYWORD_CASE)
-			return TOK_CASE;
-		else if (ID_STRING == KEYWORD_PARSE)
-			return TOK_PARSE;
-		else if (ID_STRING == KEYWORD_CONTINUE)
-			return TOK_CONTINUE;
-		else if (ID_STRING == KEYWORD_CALL_OP)
-			return TOK_CALL_OP;
-		else if (ID_STRING == KEYWORD_ANY)
-			return TOK_ANY;
-		else if (ID_STRING == KEYWORD_CONST)
-			return TOK_CONST;
-		else if (ID_STRING == KEYWORD_EACH)
-			return TOK_EACH;
-		else if (ID_STRING == KEYWORD_WHERE)
-			return TOK_WHERE;
-		else if (ID_STRING == KEYWORD_DEF)
-			return TOK_DEF;
-		else if (ID_STRING == "inf")
+		const auto it = KEYWORD_TOKENS.find(ID_STRING);
+		if (it != KEYWORD_TOKENS.end())
+			return it->second;
+		if (ID_STRING == "inf")
 		{
 			return TOK_NUM;
 		}
@@ -202,14 +157,11 @@ const int getToken(
 	}
 	else if (last == '#')
 	{
-		std::string commentStr = "";
 		do
 		{
 			last = nextChar(INPUT, INPUT_INDEX, LINE_INDEX, TOKEN_DIST);
-			commentStr += last;
 		} while (last != EOF && last != '\n' && last != '\r');
 
-		ID_STRING = commentStr;
 		return '#';
 	}
 	else if (last == EOF || last == 0)
@@ -406,16 +358,52 @@ const int getToken(
 	return ret;
 }
 
-const std::vector<token_t> lexString(const std::string &INPUT, const std::filesystem::path &filename)
+source_t::source_t(const std::filesystem::path &filename, std::string &&code) : filename(filename), content(std::move(code))
 {
-	std::vector<std::string> LINES;
-	std::stringstream ss(INPUT);
-	std::string item;
-
-	while (std::getline(ss, item, '\n'))
+	size_t i = 0;
+	while (i < content.size())
 	{
-		LINES.push_back(item);
+		lines.push_back(i);
+		size_t indent = 0;
+		while (i + indent < content.size() && content[i + indent] != '\n' && isspace(content[i + indent]))
+			indent++;
+		indents.push_back(indent);
+		i = content.find('\n', i);
+		if (i == std::string::npos)
+			break;
+		i++;
 	}
+}
+
+const std::string source_t::getLine(const size_t &i) const
+{
+	if (i >= lines.size())
+		return "";
+	const size_t start = lines[i] + indents[i];
+	size_t end = content.find('\n', start);
+	if (end == std::string::npos)
+		end = content.size();
+	return content.substr(start, end - start);
+}
+
+const std::filesystem::path token_t::getFilename() const
+{
+	if (source == nullptr)
+		return "";
+	return source->filename;
+}
+
+const std::string token_t::getLine() const
+{
+	if (source == nullptr)
+		return "";
+	return source->getLine(lineNumber);
+}
+
+const std::vector<token_t> lexString(std::string code, const std::filesystem::path &filename)
+{
+	const auto source = std::make_shared<const source_t>(filename, std::move(code));
+	const std::string &INPUT = source->content;
 
 	std::vector<token_t> tokens;
 	size_t INPUT_INDEX = 0;
@@ -432,7 +420,8 @@ const std::vector<token_t> lexString(const std::string &INPUT, const std::filesy
 			break;
 		if (token == '#')
 			continue;
-		token_t t = {filename, LINES[LINE_INDEX], LINE_INDEX, TOKEN_DIST, ID_STRING, token};
+		const size_t indent = LINE_INDEX < source->indents.size() ? std::min(source->indents[LINE_INDEX], TOKEN_DIST) : 0;
+		token_t t = {source, LINE_INDEX, TOKEN_DIST - indent, ID_STRING, token};
 		if (t.type == TOK_DEF)
 		{
 			in_sig = true;
@@ -448,18 +437,18 @@ const std::vector<token_t> lexString(const std::string &INPUT, const std::filesy
 				}
 				if (t.type != TOK_IDF && t.valueString == ">>")
 				{
-					tokens.push_back({t.filename, t.line, t.lineNumber, t.distance, ">", '>'});
-					tokens.push_back({t.filename, t.line, t.lineNumber, t.distance, ">", '>'});
+					tokens.push_back({t.source, t.lineNumber, t.distance, ">", '>'});
+					tokens.push_back({t.source, t.lineNumber, t.distance, ">", '>'});
 				}
 				else if (t.type != TOK_IDF && t.valueString == "<<")
 				{
-					tokens.push_back({t.filename, t.line, t.lineNumber, t.distance, "<", '<'});
-					tokens.push_back({t.filename, t.line, t.lineNumber, t.distance, "<", '<'});
+					tokens.push_back({t.source, t.lineNumber, t.distance, "<", '<'});
+					tokens.push_back({t.source, t.lineNumber, t.distance, "<", '<'});
 				}
 				else if (t.type != TOK_IDF && t.valueString == "<>")
 				{
-					tokens.push_back({t.filename, t.line, t.lineNumber, t.distance, "<", '<'});
-					tokens.push_back({t.filename, t.line, t.lineNumber, t.distance, ">", '>'});
+					tokens.push_back({t.source, t.lineNumber, t.distance, "<", '<'});
+					tokens.push_back({t.source, t.lineNumber, t.distance, ">", '>'});
 				}
 				else
 				{
@@ -477,14 +466,5 @@ const std::vector<token_t> lexString(const std::string &INPUT, const std::filesy
 		}
 	}
 
-	for (auto &t : tokens)
-	{
-		while (!t.line.empty() && isspace(t.line[0]))
-		{
-			t.line = t.line.substr(1);
-			t.distance--;
-		}
-	}
-
 	return tokens;
 }
@@ -3,6 +3,8 @@
 
 #include <filesystem>
 #include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 enum token_type_enum
@@ -76,7 +78,8 @@ enum token_type_enum
 	TOK_NO_PARAM_LAMBDA = -60,
 	TOK_VAR_ARGS = -61,
 	TOK_CONST = -62,
-	TOK_WHERE = -63
+	TOK_WHERE = -63,
+	TOK_GC = -64
 };
 
 const std::map<std::string, signed int> BINARY_OPERATORS = {
@@ -141,14 +144,27 @@ const std::map<std::string, signed int> UNARY_OPERATORS = {
 	{"@", -1},
 	{"$", -1}};
 
+struct source_t
+{
+	const std::filesystem::path filename;
+	const std::string content;
+	std::vector<size_t> lines;
+	std::vector<size_t> indents;
+
+	source_t(const std::filesystem::path &, std::string &&);
+	const std::string getLine(const size_t &) const;
+};
+
 struct token_t
 {
-	std::filesystem::path filename;
-	std::string line;
+	std::shared_ptr<const source_t> source;
 	size_t lineNumber;
 	size_t distance;
 	std::string valueString;
 	int type = NULL_TOK;
+
+	const std::filesystem::path getFilename() const;
+	const std::string getLine() const;
 };
 
 const char peekChar(
@@ -170,7 +186,7 @@ const int getToken(
 	std::string &);
 
 const std::vector<token_t> lexString(
-    const std::string &,
+    std::string,
     const std::filesystem::path &);
 
 #endif
\ No newline at end of file
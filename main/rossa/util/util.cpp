@@ -9,28 +9,33 @@
 
 const std::string util::format(const std::string &fmt, const std::vector<std::string> &args)
 {
-    std::string in(fmt), out;        // unformatted and formatted strings
-    std::regex re_arg("\\{\\d+\\}"); // search for {0}, {1}, ...
-    std::regex re_idx("\\d+");       // search for 0, 1, ...
-    std::smatch m_arg, m_idx;        // store matches
-    size_t idx = 0;                  // index of argument inside {...}
+    std::string out;
+    out.reserve(fmt.size());
 
-    // Replace all {x} with vbuf[x]
-    while (std::regex_search(in, m_arg, re_arg))
+    // Replace all {x} with args[x] in a single pass
+    size_t i = 0;
+    while (i < fmt.size())
     {
-        out += m_arg.prefix();
-        auto text = m_arg[0].str();
-        if (std::regex_search(text, m_idx, re_idx))
+        const size_t open = fmt.find('{', i);
+        if (open == std::string::npos)
+            break;
+        size_t j = open + 1;
+        size_t idx = 0;
+        while (j < fmt.size() && fmt[j] >= '0' && fmt[j] <= '9')
+            idx = idx * 10 + (fmt[j++] - '0');
+        if (j == open + 1 || j >= fmt.size() || fmt[j] != '}')
         {
-            idx = std::stoi(m_idx[0].str());
+            // not a placeholder; copy through the brace
+            out.append(fmt, i, open + 1 - i);
+            i = open + 1;
+            continue;
         }
+        out.append(fmt, i, open - i);
         if (idx < args.size())
-        {
-            out += std::regex_replace(text, re_arg, args[idx]);
-        }
-        in = m_arg.suffix();
+            out += args[idx];
+        i = j + 1;
     }
-    out += in;
+    out.append(fmt, i, std::string::npos);
     return out;
 }
 
@@ -2,7 +2,7 @@
 #define UTIL_H
 
 #include <string>
-#include <regex>
+#include <vector>
 #include <filesystem>
 
 namespace util
@@ -2,6 +2,19 @@
 
 #include "../function/function.h"
 #include "../signature/signature.h"
+#include "../pool/pool.h"
+
+#ifndef _NO_POOL_
+void *value_t::operator new(size_t size)
+{
+	return pool_t<sizeof(value_t)>::allocate();
+}
+
+void value_t::operator delete(void *p)
+{
+	pool_t<sizeof(value_t)>::deallocate(p);
+}
+#endif
 
 value_t::value_t()
 	: type{NIL}
@@ -29,8 +42,9 @@ value_t::value_t(const object_t &valueObject)
 }
 
 value_t::value_t(const signature_t &ftype, const ptr_function_t &function)
-	: type{FUNCTION}, value{wrapper_t({{function->params.size(), {{ftype, function}}}}, nullptr)}
+	: type{FUNCTION}, value{wrapper_t({}, nullptr)}
 {
+	std::get<wrapper_t>(value).map[function->params.size()].emplace(ftype, function);
 }
 
 value_t::value_t(const ptr_function_t &function)
@@ -13,6 +13,7 @@
 class value_t
 {
 	friend class symbol_t;
+	friend class collector_t;
 
 public:
 	const unsigned int hash() const;
@@ -32,7 +33,12 @@ private:
 		object_t>
 		value;
 
-	refc_ull references = 1;
+	std::atomic<refc_ull> references{1};
+
+#ifndef _NO_POOL_
+	static void *operator new(size_t);
+	static void operator delete(void *);
+#endif
 
 	~value_t();
 	value_t();
@@ -0,0 +1,43 @@
+#include "../main/rossa/host/host.h"
+
+#include <iostream>
+
+// Runs Rossa inside a C++ program: `make embed`, then `build/nix/ENG/embed bin/lib`
+int main(int argc, char const *argv[])
+{
+	if (argc != 2)
+	{
+		std::cerr << "Usage: embed <library-path>\n";
+		return 1;
+	}
+
+	try
+	{
+		host_t host({}, true, argv[1]);
+		host.run(*host.compile(
+			"greeting := \"Hello\";\n"
+			"fn greet(ref name: String) greeting ++ \", \" ++ name ++ \"!\";\n"
+			"fn total(ref values: Array) values.foldl(0, fn(a, b) a + b);\n",
+			std::filesystem::current_path() / "<embed>"));
+
+		auto greet = host.getHook("greet");
+		auto total = host.getHook("total");
+
+		std::cout << COERCE_STRING(greet.call({MAKE_STRING("embedder")})) << "\n";
+
+		std::vector<mediator_t> values;
+		for (long_int_t i = 1; i <= 10; i++)
+			values.push_back(MAKE_NUMBER(number_t::Long(i)));
+		auto sum = total.call({mediator_t(MEDIATOR_ARRAY, std::make_shared<std::vector<mediator_t>>(values))});
+		std::cout << "1 + ... + 10 = " << COERCE_NUMBER(sum).getLong() << "\n";
+
+		// Errors in Rossa code reach the host as rossa_error_t
+		greet.call({MAKE_NUMBER(number_t::Long(1))});
+	}
+	catch (const rossa_error_t &e)
+	{
+		std::cout << "Error: " << e.what() << "\n";
+	}
+
+	return 0;
+}